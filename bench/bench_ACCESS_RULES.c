@@ -0,0 +1,60 @@
+/*
+ * bench_ACCESS_RULES.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ *
+ * Compila los horarios de 100k usuarios y mide el costo del chequeo que hace validar_id_tarjeta.
+ */
+
+#include "ACCESS_RULES.h"
+#include <stdio.h>
+#include <time.h>
+
+#define USUARIOS 100000U
+#define CHEQUEOS 10000000U
+
+static volatile uint32_t sumidero;
+
+static uint64_t ahora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+int main(void) {
+    static const access_window oficina[] = {{ACCESS_WEEKDAYS, 8 * 60, 18 * 60}};
+    static const access_window guardia[] = {{ACCESS_ALL_DAYS, 22 * 60, 6 * 60},
+                                            {ACCESS_SATURDAY, 9 * 60, 13 * 60}};
+    uint32_t permitidos = 0;
+
+    ACCESS_RULES_Init(0x0001);
+
+    uint64_t t = ahora_ns();
+    for (uint32_t id = 0; id < USUARIOS; id++) {
+        if (id % 10 == 0) {
+            ACCESS_RULES_Compile(id, guardia, 2, 0x0003, true);
+        } else {
+            ACCESS_RULES_Compile(id, oficina, 1, (uint16_t)(1U << (id % 3)), false);
+        }
+    }
+    double compilar = (double)(ahora_ns() - t) / 1e6;
+
+    ACCESS_RULES_SetTime(2, 10 * 60, 120);
+    t = ahora_ns();
+    for (uint32_t i = 0; i < CHEQUEOS; i++) {
+        /*Acceso disperso para no quedarse siempre en cache*/
+        permitidos += ACCESS_RULES_Check((i * 7919U) % USUARIOS);
+    }
+    double chequeo = (double)(ahora_ns() - t) / CHEQUEOS;
+    sumidero = permitidos;
+
+    printf("slot de %u min, %u bits por semana\n", ACCESS_RULES_SLOT_MINUTES,
+           ACCESS_RULES_WEEK_SLOTS);
+    printf("memoria: %u bytes por usuario, %.2f MiB para %u usuarios\n",
+           ACCESS_RULES_GetBytesPerUser(),
+           (double)ACCESS_RULES_GetBytesPerUser() * USUARIOS / (1024.0 * 1024.0), USUARIOS);
+    printf("compilacion de %u horarios: %.1f ms\n", USUARIOS, compilar);
+    printf("chequeo: %.2f ns (%u de %u permitidos)\n", chequeo, permitidos, CHEQUEOS);
+    return 0;
+}
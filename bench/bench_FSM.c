@@ -0,0 +1,177 @@
+/*
+ * bench_FSM.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ *
+ * Mide el costo de despachar eventos con fsm() sobre las tablas compiladas y sobre las mismas
+ * tablas cargadas como imagen con FSM_IMAGE. Los drivers son stubs vacios: solo cuenta la FSM.
+ * Compilado con FSM_SWITCH_DISPATCH (bench_FSM_SWITCH) las compiladas usan el switch generado y
+ * las cargadas siguen recorriendo tablas, asi que compara los dos despachos.
+ */
+
+#include "FSM.h"
+#include "FSM_IMAGE.h"
+#include "TASKS.h"
+#include "METRICS.h"
+#include "LOCKOUT.h"
+#include "RC522.h"
+#include "TTP229.h"
+#include "LED.h"
+#include "TIMER.h"
+#include "USERS_DATA.h"
+#include "ACCESS_RULES.h"
+#include <stdio.h>
+#include <time.h>
+
+#ifdef FSM_SWITCH_DISPATCH
+#define DESPACHO "switch generado"
+#else
+#define DESPACHO "tablas compiladas"
+#endif
+
+#define SESIONES     1000000U
+#define REPETICIONES 5
+
+/*Una sesion completa: tarjeta, PIN equivocado, PIN correcto y cierre de la puerta, con algunos
+ * eventos que el estado actual no atiende*/
+static const eventos sesion[] = {
+    LECTURA_NUMERO_TECLADO, LECTURA_TARJETA,        TARJETA_VALIDA,         LECTURA_NUMERO_TECLADO,
+    LECTURA_NUMERO_TECLADO, LECTURA_NUMERO_TECLADO, LECTURA_NUMERO_TECLADO, PIN_INVALIDO,
+    LECTURA_TARJETA,        LECTURA_NUMERO_TECLADO, LECTURA_NUMERO_TECLADO, LECTURA_NUMERO_TECLADO,
+    LECTURA_NUMERO_TECLADO, PIN_VALIDO,             TIMEOUT_PUERTA_ABIERTA, TIMEOUT_DEFAULT};
+
+/*Eventos que la puerta cerrada no atiende: recorren toda la tabla hasta FIN_TABLA y solo llaman a
+ * no_operation, el caso en el que mas pesa el despacho*/
+static const eventos ignorados[] = {LECTURA_NUMERO_TECLADO, PIN_VALIDO, TARJETA_VALIDA,
+                                    PIN_INVALIDO};
+
+#define CANTIDAD(eventos) (sizeof(eventos) / sizeof(eventos[0]))
+
+static uint8_t tarjeta[4] = {0x93, 0x2A, 0x4C, 0x1B};
+static volatile uint32_t sumidero;
+
+/*Stubs de los drivers que llaman las rutinas de accion*/
+uint8_t * GetKeyRead(void) {
+    return tarjeta;
+}
+bool get_RFID_event_ocurrence(void) {
+    return false;
+}
+uint8_t KEYBOARD_ReadData(void) {
+    return 0;
+}
+void LED_KeyboardPress(void) {
+}
+void LED_Card_Blink(void) {
+}
+void LED_OPEN_DOOR(void) {
+}
+void LED_Wrong_Pin_Blink(void) {
+}
+void TIMER_Start(TIMERS myTimer) {
+    (void)myTimer;
+}
+uint8_t TIME_GetTimeStatus(TIMERS myTimer) {
+    (void)myTimer;
+    return 0;
+}
+void TIME_ResetTimeStatus(TIMERS myTimer) {
+    (void)myTimer;
+}
+bool USERS_DATA_VALIDATE_KEYCARD(uint8_t * KeyCardReaded) {
+    return KeyCardReaded[0] == tarjeta[0];
+}
+bool USERS_DATA_KEYCARD_PENDING(void) {
+    return false;
+}
+uint32_t USERS_DATA_GET_CURRENT_USER_ID(void) {
+    return 1;
+}
+void USERS_DATA_COLLECT_FIRST_NUMBER(uint8_t * PIN_FirstNumber) {
+    (void)PIN_FirstNumber;
+}
+void USERS_DATA_COLLECT_SECOND_NUMBER(uint8_t * PIN_SecondNumber) {
+    (void)PIN_SecondNumber;
+}
+void USERS_DATA_COLLECT_THIRD_NUMBER(uint8_t * PIN_ThirdNumber) {
+    (void)PIN_ThirdNumber;
+}
+void USERS_DATA_COLLECT_FOURTH_NUMBER(uint8_t * PIN_FourtNumber) {
+    (void)PIN_FourtNumber;
+}
+bool USERS_DATA_VALIDATE_PIN(void) {
+    return true;
+}
+bool ACCESS_RULES_Check(uint32_t user_id) {
+    return user_id != 0;
+}
+
+static uint32_t reloj_fijo(void) {
+    return 0;
+}
+
+static uint64_t ahora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+/*Devuelve ns por evento, el mejor de varias repeticiones. La suma de los ids de los estados
+ * recorridos tiene que dar igual con las dos tablas*/
+static double medir(const eventos * secuencia, uint32_t cantidad, uint32_t * recorrido) {
+    double mejor = 1e9;
+
+    for (int r = 0; r < REPETICIONES; r++) {
+        const STATE * estado = FSM_GetInitState();
+        uint32_t suma = 0;
+        uint64_t t = ahora_ns();
+        for (uint32_t s = 0; s < SESIONES; s++) {
+            for (uint32_t e = 0; e < cantidad; e++) {
+                estado = fsm(estado, secuencia[e]);
+            }
+            suma += FSM_GetStateId(estado);
+        }
+        double ns = (double)(ahora_ns() - t) / ((double)SESIONES * cantidad);
+        mejor = ns < mejor ? ns : mejor;
+        *recorrido += suma;
+    }
+    return mejor;
+}
+
+static void comparar(const char * nombre, double compiladas, double cargadas) {
+    printf("%s\n", nombre);
+    printf("  %-18s %.2f ns por evento\n", DESPACHO ":", compiladas);
+    printf("  %-18s %.2f ns por evento (%+.1f%%)\n", "tablas cargadas:", cargadas,
+           100.0 * (cargadas - compiladas) / compiladas);
+}
+
+int main(void) {
+    static uint8_t imagen[FSM_IMAGE_LEN(FSM_IMAGE_MAX_EDGES)];
+    uint32_t recorrido_compiladas = 0;
+    uint32_t recorrido_imagen = 0;
+
+    TASKS_Init(reloj_fijo);
+    METRICS_Init(NULL);
+    LOCKOUT_Init(reloj_fijo);
+
+    double sesion_compiladas = medir(sesion, CANTIDAD(sesion), &recorrido_compiladas);
+    double ignorados_compiladas = medir(ignorados, CANTIDAD(ignorados), &recorrido_compiladas);
+
+    uint16_t largo = FSM_IMAGE_Export(imagen, sizeof(imagen));
+    uint64_t t = ahora_ns();
+    fsm_image_status estado = FSM_IMAGE_Load(imagen, largo);
+    double carga = (double)(ahora_ns() - t) / 1e3;
+    FSM_IMAGE_Apply(FSM_GetInitState());
+
+    double sesion_cargadas = medir(sesion, CANTIDAD(sesion), &recorrido_imagen);
+    double ignorados_cargadas = medir(ignorados, CANTIDAD(ignorados), &recorrido_imagen);
+    sumidero = recorrido_compiladas + recorrido_imagen;
+
+    printf("imagen de %u bytes, validacion y enlace: %.2f us (%s)\n", largo, carga,
+           estado == FSM_IMAGE_OK ? "ok" : "rechazada");
+    comparar("sesion completa", sesion_compiladas, sesion_cargadas);
+    comparar("eventos ignorados", ignorados_compiladas, ignorados_cargadas);
+    printf("recorridos %s\n", recorrido_compiladas == recorrido_imagen ? "iguales" : "DISTINTOS");
+    return 0;
+}
@@ -0,0 +1,11 @@
+/*
+ * bench_FSM_SWITCH.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ *
+ * El mismo benchmark que bench_FSM, enlazado con FSM.c compilado con FSM_SWITCH_DISPATCH (ver
+ * bench_FSM_SWITCH_FLAGS en el makefile).
+ */
+
+#include "bench_FSM.c"
@@ -0,0 +1,160 @@
+/*
+ * bench_USERS_INDEX.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ *
+ * Aplica un delta de 10k registros en un hilo aparte mientras el hilo principal sigue
+ * validando tarjetas, y reporta la latencia de las busquedas antes y durante la sincronizacion.
+ */
+
+#include "USERS_INDEX.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define USUARIOS       10000U
+#define PASO_SYNC      256U
+#define MUESTRAS_ANTES 200000U
+#define MAX_MUESTRAS   4000000U
+
+static uint8_t * delta;
+static atomic_bool terminado;
+static uint32_t * latencias;
+
+static uint64_t ahora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static void escribir_u32(uint8_t * p, uint32_t valor) {
+    p[0] = (uint8_t)valor;
+    p[1] = (uint8_t)(valor >> 8);
+    p[2] = (uint8_t)(valor >> 16);
+    p[3] = (uint8_t)(valor >> 24);
+}
+
+static void uid_de(uint32_t n, uint8_t * uid) {
+    uid[0] = (uint8_t)(n >> 24);
+    uid[1] = (uint8_t)(n >> 16);
+    uid[2] = (uint8_t)(n >> 8);
+    uid[3] = (uint8_t)n;
+}
+
+/*Los UID pares existen desde el principio, el delta modifica la mitad y agrega los impares*/
+static uint32_t armar_delta(uint32_t base, uint32_t nueva, bool inicial) {
+    uint32_t cantidad = 0;
+    uint8_t * registro = &delta[USERS_DELTA_HEADER_LEN];
+
+    for (uint32_t n = 0; n < 2 * USUARIOS; n++) {
+        uint8_t op;
+        if (inicial) {
+            if (n % 2 != 0) {
+                continue;
+            }
+            op = USERS_DELTA_ADD;
+        } else if (n % 2 != 0) {
+            op = USERS_DELTA_ADD;
+        } else if (n % 4 == 0) {
+            op = USERS_DELTA_MODIFY;
+        } else {
+            continue;
+        }
+        registro[0] = op;
+        uid_de(n * 7919U, &registro[1]);
+        memset(&registro[5], (int)(n % 10), 4);
+        escribir_u32(&registro[9], n);
+        registro += USERS_DELTA_RECORD_LEN;
+        cantidad++;
+        if (!inicial && cantidad == USUARIOS) {
+            break;
+        }
+    }
+    memcpy(delta, USERS_DELTA_MAGIC, 4);
+    escribir_u32(&delta[4], base);
+    escribir_u32(&delta[8], nueva);
+    escribir_u32(&delta[12], cantidad);
+    return USERS_DELTA_HEADER_LEN + cantidad * USERS_DELTA_RECORD_LEN;
+}
+
+static void * sincronizar(void * arg) {
+    uint32_t len = *(uint32_t *)arg;
+    uint64_t peor_paso = 0;
+    uint64_t inicio = ahora_ns();
+
+    USERS_INDEX_BeginDelta(delta, len);
+    for (;;) {
+        uint64_t t = ahora_ns();
+        users_sync_status estado = USERS_INDEX_SyncStep(PASO_SYNC);
+        t = ahora_ns() - t;
+        peor_paso = t > peor_paso ? t : peor_paso;
+        if (estado != USERS_SYNC_BUSY) {
+            break;
+        }
+    }
+    printf("sync 10k registros: %.2f ms total, peor paso de %u registros %.1f us\n",
+           (double)(ahora_ns() - inicio) / 1e6, PASO_SYNC, (double)peor_paso / 1e3);
+    atomic_store(&terminado, true);
+    return NULL;
+}
+
+static int comparar_latencia(const void * a, const void * b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void medir_busquedas(const char * titulo, bool durante_sync) {
+    uint64_t total = 0;
+    uint32_t muestras = 0;
+    uint8_t uid[4];
+
+    while (durante_sync ? !atomic_load(&terminado) : muestras < MUESTRAS_ANTES) {
+        uid_de((muestras % (2 * USUARIOS)) * 7919U, uid);
+        uint64_t t = ahora_ns();
+        USERS_INDEX_Lookup(uid, NULL);
+        t = ahora_ns() - t;
+        total += t;
+        if (muestras < MAX_MUESTRAS) {
+            latencias[muestras] = (uint32_t)t;
+        }
+        muestras++;
+    }
+    uint32_t guardadas = muestras < MAX_MUESTRAS ? muestras : MAX_MUESTRAS;
+    qsort(latencias, guardadas, sizeof(uint32_t), comparar_latencia);
+    printf("%-22s %8u busquedas, media %6.1f ns, p99 %6u ns, p99.9 %6u ns\n", titulo, muestras,
+           (double)total / muestras, latencias[guardadas * 99 / 100],
+           latencias[guardadas * 999 / 1000]);
+}
+
+int main(void) {
+    pthread_t hilo;
+    uint32_t len;
+
+    delta = malloc(USERS_DELTA_HEADER_LEN + 2 * USUARIOS * USERS_DELTA_RECORD_LEN);
+    latencias = malloc(MAX_MUESTRAS * sizeof(uint32_t));
+    USERS_INDEX_Init(NULL, 0);
+    len = armar_delta(1, 2, true);
+    USERS_INDEX_BeginDelta(delta, len);
+    while (USERS_INDEX_SyncStep(UINT32_MAX) == USERS_SYNC_BUSY) {
+    }
+    printf("indice inicial: %u usuarios (version %u)\n", USERS_INDEX_GetCount(),
+           USERS_INDEX_GetVersion());
+
+    medir_busquedas("sin sincronizacion:", false);
+
+    len = armar_delta(2, 3, false);
+    pthread_create(&hilo, NULL, sincronizar, &len);
+    medir_busquedas("durante el delta:", true);
+    pthread_join(hilo, NULL);
+    printf("indice final: %u usuarios (version %u)\n", USERS_INDEX_GetCount(),
+           USERS_INDEX_GetVersion());
+
+    free(latencias);
+    free(delta);
+    return 0;
+}
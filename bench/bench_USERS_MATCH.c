@@ -0,0 +1,97 @@
+/*
+ * bench_USERS_MATCH.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ *
+ * Compara la busqueda escalar de UIDs contra la vectorizada, la busqueda binaria del indice y la
+ * auditoria por lote.
+ */
+
+#include "USERS_MATCH.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define MAX_COLUMNA 10000U
+#define AUDITORIA   1000U
+
+static uint32_t columna[MAX_COLUMNA];
+static volatile int32_t sumidero;
+
+static uint64_t ahora_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+static int32_t buscar_binaria(const uint32_t * uids, uint32_t cantidad, uint32_t uid) {
+    uint32_t inicio = 0;
+    uint32_t fin = cantidad;
+    while (inicio < fin) {
+        uint32_t medio = inicio + (fin - inicio) / 2;
+        if (uids[medio] == uid) {
+            return (int32_t)medio;
+        }
+        if (uids[medio] < uid) {
+            inicio = medio + 1;
+        } else {
+            fin = medio;
+        }
+    }
+    return USERS_MATCH_NOT_FOUND;
+}
+
+/*Tiempo medio por busqueda de un UID que no esta (peor caso del recorrido lineal)*/
+static double medir(int32_t (*buscar)(const uint32_t *, uint32_t, uint32_t), uint32_t cantidad) {
+    uint32_t repeticiones = 20000000U / (cantidad + 16);
+    uint64_t inicio = ahora_ns();
+    for (uint32_t r = 0; r < repeticiones; r++) {
+        sumidero = buscar(columna, cantidad, 2 * r + 1);
+    }
+    return (double)(ahora_ns() - inicio) / repeticiones;
+}
+
+int main(void) {
+    static const uint32_t largos[] = {16, 32, 64, 128, 256, 1024, MAX_COLUMNA};
+    static uint32_t sondas[AUDITORIA];
+    static int32_t posiciones[AUDITORIA];
+
+    USERS_MATCH_Init();
+    for (uint32_t i = 0; i < MAX_COLUMNA; i++) {
+        columna[i] = 2 * i * 7919U; // Pares y ordenados, los impares nunca estan
+    }
+
+    printf("implementacion vectorizada: %s\n", USERS_MATCH_GetImplementation());
+    printf("%8s %12s %12s %12s %9s\n", "usuarios", "escalar ns", "simd ns", "binaria ns",
+           "speedup");
+    for (uint32_t i = 0; i < sizeof(largos) / sizeof(largos[0]); i++) {
+        double escalar = medir(USERS_MATCH_FindScalar, largos[i]);
+        double simd = medir(USERS_MATCH_Find, largos[i]);
+        double binaria = medir(buscar_binaria, largos[i]);
+        printf("%8u %12.1f %12.1f %12.1f %8.1fx\n", largos[i], escalar, simd, binaria,
+               escalar / simd);
+    }
+
+    /*Auditoria: la mitad de las tarjetas exportadas existen*/
+    for (uint32_t j = 0; j < AUDITORIA; j++) {
+        sondas[j] = (j % 2) ? 2 * (j * 9U % MAX_COLUMNA) * 7919U : 2 * j + 1;
+    }
+    uint64_t t = ahora_ns();
+    for (uint32_t j = 0; j < AUDITORIA; j++) {
+        posiciones[j] = USERS_MATCH_FindScalar(columna, MAX_COLUMNA, sondas[j]);
+    }
+    double escalar = (double)(ahora_ns() - t) / 1e3;
+    t = ahora_ns();
+    USERS_MATCH_Batch(columna, MAX_COLUMNA, sondas, AUDITORIA, posiciones);
+    double lote = (double)(ahora_ns() - t) / 1e3;
+    t = ahora_ns();
+    for (uint32_t j = 0; j < AUDITORIA; j++) {
+        posiciones[j] = buscar_binaria(columna, MAX_COLUMNA, sondas[j]);
+    }
+    double binaria = (double)(ahora_ns() - t) / 1e3;
+    printf("auditoria %u tarjetas contra %u usuarios: escalar %.0f us, lote simd %.0f us, "
+           "binaria %.0f us\n",
+           AUDITORIA, MAX_COLUMNA, escalar, lote, binaria);
+    return 0;
+}
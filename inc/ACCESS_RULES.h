@@ -0,0 +1,68 @@
+/*
+ * ACCESS_RULES.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_ACCESS_RULES_H_
+#define API_INC_ACCESS_RULES_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Cantidad de usuarios con horario propio, con cualquier id de usuario del indice*/
+#ifndef ACCESS_RULES_MAX_USERS
+#define ACCESS_RULES_MAX_USERS 64
+#endif
+/*Resolucion del horario semanal: 60 min -> 168 bits por usuario, 15 min -> 672 bits*/
+#ifndef ACCESS_RULES_SLOT_MINUTES
+#define ACCESS_RULES_SLOT_MINUTES 60
+#endif
+
+#define ACCESS_RULES_SLOTS_PER_DAY (1440 / ACCESS_RULES_SLOT_MINUTES)
+#define ACCESS_RULES_WEEK_SLOTS    (7 * ACCESS_RULES_SLOTS_PER_DAY)
+#define ACCESS_RULES_WEEK_BYTES    ((ACCESS_RULES_WEEK_SLOTS + 7) / 8)
+
+/*Dias de la semana para las ventanas horarias*/
+#define ACCESS_MONDAY    (1U << 0)
+#define ACCESS_TUESDAY   (1U << 1)
+#define ACCESS_WEDNESDAY (1U << 2)
+#define ACCESS_THURSDAY  (1U << 3)
+#define ACCESS_FRIDAY    (1U << 4)
+#define ACCESS_SATURDAY  (1U << 5)
+#define ACCESS_SUNDAY    (1U << 6)
+#define ACCESS_WEEKDAYS  0x1FU
+#define ACCESS_ALL_DAYS  0x7FU
+
+#define ACCESS_ALL_GROUPS 0xFFFFU
+
+/*Reloj sin fijar: desde ACCESS_RULES_Init hasta el primer ACCESS_RULES_SetTime la hora es
+ * desconocida. En ese estado se falla cerrado: ningun usuario con horario pasa ACCESS_RULES_Check,
+ * los que no tienen horario siguen sin restricciones. Sin RTC que llame a SetTime los horarios
+ * dejan afuera a sus usuarios en lugar de evaluarse contra una hora inventada*/
+
+/*Ventana [desde, hasta) en minutos desde la medianoche. Si hasta < desde termina al dia siguiente.
+ * Los limites que no caen justo en un slot se redondean hacia adentro*/
+typedef struct {
+    uint8_t dias;
+    uint16_t desde;
+    uint16_t hasta;
+} access_window;
+
+/*Cambio de id de un usuario que sigue existiendo: su horario pasa al id nuevo*/
+typedef struct {
+    uint32_t viejo;
+    uint32_t nuevo;
+} access_id_change;
+
+void ACCESS_RULES_Init(uint16_t grupo_puerta);
+bool ACCESS_RULES_Compile(uint32_t user_id, const access_window * ventanas, uint8_t cantidad,
+                          uint16_t grupos, bool feriados);
+void ACCESS_RULES_Remove(uint32_t user_id);
+void ACCESS_RULES_Renumber(const access_id_change * cambios, uint32_t cantidad);
+void ACCESS_RULES_SetHoliday(uint16_t dia_del_anio, bool feriado);
+void ACCESS_RULES_SetTime(uint8_t dia_semana, uint16_t minuto_del_dia, uint16_t dia_del_anio);
+bool ACCESS_RULES_Check(uint32_t user_id);
+uint32_t ACCESS_RULES_GetBytesPerUser(void);
+
+#endif /* API_INC_ACCESS_RULES_H_ */
@@ -0,0 +1,38 @@
+/*
+ * BOOT.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_BOOT_H_
+#define API_INC_BOOT_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BOOT_MAX_STAGES 16
+#define BOOT_STAGE(n)   (1UL << (n)) // Para armar la mascara de dependencias
+
+/*Etapa de arranque. Cada etapa queda lista al volver de iniciar(); las que no son criticas se
+ * difieren hasta que la FSM ya acepta eventos. Los drivers de este arbol hacen sus esperas adentro
+ * de su Init, asi que no hay esperas que solapar entre etapas*/
+typedef struct {
+    const char * nombre;
+    void (*iniciar)(void);
+    uint32_t dependencias;  // Mascara BOOT_STAGE() de etapas que tienen que estar listas antes
+    bool diferida;          // Se completa con la FSM ya aceptando eventos
+} boot_stage;
+
+typedef struct {
+    uint32_t inicio_us;
+    uint32_t lista_us;
+    bool omitida;
+} boot_timeline_entry;
+
+void BOOT_Init(const boot_stage * etapas, uint8_t cantidad, uint32_t (*reloj_us)(void));
+void BOOT_Skip(uint8_t etapa);
+bool BOOT_Step(void);
+bool BOOT_StepDeferred(void);
+const boot_timeline_entry * BOOT_GetTimeline(void);
+
+#endif /* API_INC_BOOT_H_ */
@@ -0,0 +1,22 @@
+/*
+ * BYTES.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_BYTES_H_
+#define API_INC_BYTES_H_
+#include <stdint.h>
+#include <stddef.h>
+
+/*Campos little endian y CRC-32 (IEEE 802.3) de los formatos binarios del firmware: imagen de
+ * tablas, trama de metricas, delta de usuarios y RAM retenida. Las funciones de escritura
+ * devuelven el puntero al byte siguiente para encadenar campos*/
+uint32_t BYTES_Crc32(const uint8_t * datos, size_t largo);
+uint8_t * BYTES_PutU16(uint8_t * p, uint16_t valor);
+uint8_t * BYTES_PutU32(uint8_t * p, uint32_t valor);
+uint16_t BYTES_GetU16(const uint8_t * p);
+uint32_t BYTES_GetU32(const uint8_t * p);
+
+#endif /* API_INC_BYTES_H_ */
@@ -8,8 +8,15 @@
 #ifndef API_INC_FSM_H_
 #define API_INC_FSM_H_
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #define FIN_ARCHIVO 0xFF
 
+#define FSM_CANTIDAD_ESTADOS 8  // Estados de las tablas compiladas
+#define FSM_MAX_ESTADOS      16 // Estados que puede tener una tabla cargada con FSM_IMAGE
+#define FSM_TABLE_VERSION    1  // Version de las tablas compiladas
+
 /*Listado de Eventos*/
 typedef enum {
     LECTURA_TARJETA,
@@ -28,13 +35,38 @@ typedef struct state_diagram_edge STATE;
 struct state_diagram_edge {
 
     eventos evento;
-    STATE * proximo_estado;
+    const STATE * proximo_estado;
     void (*p_rutina_accion)(void);
 };
 
+/*Juego de tablas que recorre fsm(), el estado en la posicion 0 es el inicial (reposo)*/
+typedef struct {
+    const STATE * const * estados;
+    uint8_t cantidad;
+    uint16_t version;
+} fsm_tablas;
+
+/*Eventos pendientes que todavia no entrego get_event()*/
+typedef struct {
+    int8_t tarjetavalida;
+    uint8_t NumeroPulsado;
+    int8_t pinValido;
+    bool timeout_activo; // TIMER_TIMEOUT fue iniciado y todavia no vencio
+} fsm_pendientes;
+
 /*Interprete de la maquina de estados*/
-STATE * fsm(STATE * p_tabla_estado, eventos evento_actual);
-STATE * FSM_GetInitState(void);
+const STATE * fsm(const STATE * p_tabla_estado, eventos evento_actual);
+const STATE * FSM_GetInitState(void);
+
+/*Cambio de tablas, solo entre dos llamadas a fsm(). NULL vuelve a las compiladas*/
+void FSM_SetTables(const fsm_tablas * tablas);
+const fsm_tablas * FSM_GetTables(void);
+
+/*Identificacion de estados y eventos pendientes, para guardar y retomar la sesion*/
+uint8_t FSM_GetStateId(const STATE * estado);
+const STATE * FSM_GetStateById(uint8_t id);
+void FSM_GetPending(fsm_pendientes * pendientes);
+void FSM_RestorePending(const fsm_pendientes * pendientes);
 
 /*Generador de eventos*/
 
@@ -52,15 +84,29 @@ void abrir_puerta(void);
 void cerrar_puerta(void);
 void reset_FSM(void);
 
+/*Numero de cada rutina de accion dentro de una imagen de tablas (FSM_IMAGE.h)*/
+typedef enum {
+    FSM_ACCION_NO_OPERATION,
+    FSM_ACCION_VALIDAR_ID_TARJETA,
+    FSM_ACCION_LECTURA_PRIMER_NUMERO,
+    FSM_ACCION_LECTURA_SEGUNDO_NUMERO,
+    FSM_ACCION_LECTURA_TERCER_NUMERO,
+    FSM_ACCION_LECTURA_CUARTO_NUMERO,
+    FSM_ACCION_ABRIR_PUERTA,
+    FSM_ACCION_CERRAR_PUERTA,
+    FSM_ACCION_RESET_FSM,
+    FSM_ACCIONES
+} fsm_accion;
+
 /*Foward Declarations*/
-extern STATE estado_puerta_cerrada[];
-extern STATE estado_validando_tarjeta[];
-extern STATE estado_ingreso_primer_numero[];
-extern STATE estado_ingreso_segundo_numero[];
-extern STATE estado_ingreso_tercer_numero[];
-extern STATE estado_ingreso_cuarto_numero[];
-extern STATE estado_validando_pin[];
-extern STATE estado_puerta_abierta[];
+extern const STATE estado_puerta_cerrada[];
+extern const STATE estado_validando_tarjeta[];
+extern const STATE estado_ingreso_primer_numero[];
+extern const STATE estado_ingreso_segundo_numero[];
+extern const STATE estado_ingreso_tercer_numero[];
+extern const STATE estado_ingreso_cuarto_numero[];
+extern const STATE estado_validando_pin[];
+extern const STATE estado_puerta_abierta[];
 
 void test_set_NumeroPulsado(char value);
 void test_set_TarjetaValida(int value);
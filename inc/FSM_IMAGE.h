@@ -0,0 +1,48 @@
+/*
+ * FSM_IMAGE.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_FSM_IMAGE_H_
+#define API_INC_FSM_IMAGE_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "FSM.h"
+
+/*Imagen de tablas de la FSM que se carga sin reprogramar (desde flash, o un archivo en Linux).
+ * Enteros little endian:
+ * "TSSF" | formato u8 | estados u8 | arcos u16 | version u16 | reservado u16 |
+ * arcos {evento u8, proximo estado u8, accion u8}[] | CRC-32 de todo lo anterior
+ * Los arcos van estado por estado, cada uno terminado en su arco FIN_TABLA. El estado 0 es el
+ * inicial y el unico en el que se puede cambiar de tablas.
+ * Solo abrir_puerta sobre PIN_VALIDO deja la puerta abierta, y cada estado al que lleva tiene
+ * que salir siempre con cerrar_puerta; por eso el estado 0 nunca puede ser uno de ellos*/
+#define FSM_IMAGE_MAGIC      "TSSF"
+#define FSM_IMAGE_FORMAT     1
+#define FSM_IMAGE_HEADER_LEN 12
+#define FSM_IMAGE_EDGE_LEN   3
+#define FSM_IMAGE_MAX_EDGES  64
+#define FSM_IMAGE_LEN(arcos) (FSM_IMAGE_HEADER_LEN + FSM_IMAGE_EDGE_LEN * (arcos) + 4)
+
+typedef enum {
+    FSM_IMAGE_OK,
+    FSM_IMAGE_ERR_LARGO,
+    FSM_IMAGE_ERR_FORMATO, // Magic, formato, o cantidad de estados o arcos fuera de rango
+    FSM_IMAGE_ERR_CRC,
+    FSM_IMAGE_ERR_EVENTO,  // Evento desconocido o repetido dentro de un estado
+    FSM_IMAGE_ERR_ESTADO,  // Proximo estado fuera de la tabla
+    FSM_IMAGE_ERR_ACCION,
+    FSM_IMAGE_ERR_TABLA,   // Estados sin su arco FIN_TABLA, o con uno que sale del estado
+    FSM_IMAGE_ERR_PUERTA   // La puerta se abre sin PIN_VALIDO o se sale de abierta sin cerrarla
+} fsm_image_status;
+
+fsm_image_status FSM_IMAGE_Validate(const uint8_t * imagen, uint16_t largo);
+fsm_image_status FSM_IMAGE_Load(const uint8_t * imagen, uint16_t largo);
+void FSM_IMAGE_LoadBuiltin(void);
+uint16_t FSM_IMAGE_Export(uint8_t * imagen, uint16_t largo);
+bool FSM_IMAGE_Pending(void);
+const STATE * FSM_IMAGE_Apply(const STATE * estado);
+
+#endif /* API_INC_FSM_IMAGE_H_ */
@@ -0,0 +1,47 @@
+/*
+ * FSM_RETAIN.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_FSM_RETAIN_H_
+#define API_INC_FSM_RETAIN_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "FSM.h"
+
+/*Sesion de la FSM guardada en RAM que no se inicializa al arrancar (seccion .noinit, el script
+ * del linker la tiene que ubicar como NOLOAD). Solo se retoma despues de un reset por watchdog o
+ * por software; con cualquier otra causa (encendido, brown-out, boton de reset) el arranque es en
+ * frio aunque el CRC coincida, porque la RAM o el RC522 pudieron perder la alimentacion.
+ * Las estadisticas de arranque tienen su propio magic y CRC y no se borran en un arranque en frio*/
+#define FSM_RETAIN_MAGIC       0x46534D52U // "FSMR"
+#define FSM_RETAIN_STATS_MAGIC 0x46534D43U // "FSMC"
+#define FSM_RETAIN_VERSION     2U
+
+typedef enum {
+    FSM_RESET_POWER_ON,
+    FSM_RESET_BROWNOUT,
+    FSM_RESET_PIN,
+    FSM_RESET_WATCHDOG,
+    FSM_RESET_SOFTWARE
+} fsm_reset_cause;
+
+typedef struct {
+    uint32_t arranques_frios;
+    uint32_t arranques_calientes;
+    uint32_t ultimo_frio_us;     // Tiempo desde el reset hasta aceptar eventos
+    uint32_t ultimo_caliente_us;
+} fsm_retain_stats;
+
+void FSM_RETAIN_Init(void * almacenamiento, fsm_reset_cause causa);
+bool FSM_RETAIN_Restore(uint8_t * estado, fsm_pendientes * pendientes);
+void FSM_RETAIN_Save(uint8_t estado, const fsm_pendientes * pendientes);
+void FSM_RETAIN_Invalidate(void);
+void FSM_RETAIN_SetPeripheralsReady(bool listos);
+bool FSM_RETAIN_GetPeripheralsReady(void);
+void FSM_RETAIN_RecordBoot(bool caliente, uint32_t arranque_us);
+const fsm_retain_stats * FSM_RETAIN_GetStats(void);
+
+#endif /* API_INC_FSM_RETAIN_H_ */
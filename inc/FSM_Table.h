@@ -10,51 +10,60 @@
 
 #include "FSM.h"
 
-/*** estado_0 ***/
-STATE estado_puerta_cerrada[] = {{LECTURA_TARJETA, estado_validando_tarjeta, validar_id_tarjeta},
-                                 {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-                                 {FIN_TABLA, estado_puerta_cerrada, no_operation}};
-/*** estado_1 ***/
-STATE estado_validando_tarjeta[] = {{TARJETA_VALIDA, estado_ingreso_primer_numero, no_operation},
-                                    {TARJETA_INVALIDA, estado_puerta_cerrada, no_operation},
-                                    {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-                                    {FIN_TABLA, estado_validando_tarjeta, no_operation}};
-/*** estado_2 ***/
-STATE estado_ingreso_primer_numero[] = {
-    {LECTURA_NUMERO_TECLADO, estado_ingreso_segundo_numero, lectura_primer_numero},
-    {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-    {FIN_TABLA, estado_ingreso_primer_numero, no_operation}};
+/*Unica definicion de la maquina de estados. De esta lista salen las tablas STATE[] que recorre
+ * fsm(), el orden de los estados (su id) y, compilando con FSM_SWITCH_DISPATCH, el switch que
+ * despacha sin recorrer tablas (ver FSM.c). Cada estado es ESTADO, sus arcos y un FIN con la
+ * rutina para los eventos que no atiende*/
+#define FSM_TABLA(ESTADO, ARCO, FIN)                                                               \
+    /*** estado_0 ***/                                                                             \
+    ESTADO(estado_puerta_cerrada)                                                                  \
+    ARCO(LECTURA_TARJETA, estado_validando_tarjeta, validar_id_tarjeta)                            \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_puerta_cerrada, no_operation)                                                       \
+    /*** estado_1 ***/                                                                             \
+    ESTADO(estado_validando_tarjeta)                                                               \
+    ARCO(TARJETA_VALIDA, estado_ingreso_primer_numero, no_operation)                               \
+    ARCO(TARJETA_INVALIDA, estado_puerta_cerrada, reset_FSM)                                       \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_validando_tarjeta, no_operation)                                                    \
+    /*** estado_2 ***/                                                                             \
+    ESTADO(estado_ingreso_primer_numero)                                                           \
+    ARCO(LECTURA_NUMERO_TECLADO, estado_ingreso_segundo_numero, lectura_primer_numero)             \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_ingreso_primer_numero, no_operation)                                                \
+    /*** estado_3 ***/                                                                             \
+    ESTADO(estado_ingreso_segundo_numero)                                                          \
+    ARCO(LECTURA_NUMERO_TECLADO, estado_ingreso_tercer_numero, lectura_segundo_numero)             \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_ingreso_segundo_numero, no_operation)                                               \
+    /*** estado_4 ***/                                                                             \
+    ESTADO(estado_ingreso_tercer_numero)                                                           \
+    ARCO(LECTURA_NUMERO_TECLADO, estado_ingreso_cuarto_numero, lectura_tercer_numero)              \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_ingreso_tercer_numero, no_operation)                                                \
+    /*** estado_5 ***/                                                                             \
+    ESTADO(estado_ingreso_cuarto_numero)                                                           \
+    ARCO(LECTURA_NUMERO_TECLADO, estado_validando_pin, lectura_cuarto_numero)                      \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_ingreso_cuarto_numero, no_operation)                                                \
+    /*** estado_6 ***/                                                                             \
+    ESTADO(estado_validando_pin)                                                                   \
+    ARCO(PIN_VALIDO, estado_puerta_abierta, abrir_puerta)                                          \
+    ARCO(PIN_INVALIDO, estado_ingreso_primer_numero, no_operation)                                 \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM)                                        \
+    FIN(estado_validando_pin, no_operation)                                                        \
+    /*** estado_7 ***/                                                                             \
+    ESTADO(estado_puerta_abierta)                                                                  \
+    /* este es el unico en el que timeout cumple un sentido logico, por eso no anula todos los */  \
+    /* comportamientos como en los otros */                                                        \
+    ARCO(TIMEOUT_DEFAULT, estado_puerta_cerrada, cerrar_puerta)                                    \
+    FIN(estado_puerta_abierta, no_operation) /* Cambiar despues */
 
-/*** estado_3 ***/
-STATE estado_ingreso_segundo_numero[] = {
-    {LECTURA_NUMERO_TECLADO, estado_ingreso_tercer_numero, lectura_segundo_numero},
-    {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-    {FIN_TABLA, estado_ingreso_segundo_numero, no_operation}};
+/*Tablas que recorre fsm()*/
+#define FSM_TABLA_ESTADO(estado)                const STATE estado[] = {
+#define FSM_TABLA_ARCO(evento, proximo, accion) {evento, proximo, accion},
+#define FSM_TABLA_FIN(estado, accion)           {FIN_TABLA, estado, accion}};
 
-/*** estado_4 ***/
-STATE estado_ingreso_tercer_numero[] = {
-    {LECTURA_NUMERO_TECLADO, estado_ingreso_cuarto_numero, lectura_tercer_numero},
-    {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-    {FIN_TABLA, estado_ingreso_tercer_numero, no_operation}};
-
-/*** estado_5 ***/
-STATE estado_ingreso_cuarto_numero[] = {
-    {LECTURA_NUMERO_TECLADO, estado_validando_pin, lectura_cuarto_numero},
-    {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-    {FIN_TABLA, estado_ingreso_cuarto_numero, no_operation}};
-
-/*** estado_6 ***/
-STATE estado_validando_pin[] = {{PIN_VALIDO, estado_puerta_abierta, abrir_puerta},
-                                {PIN_INVALIDO, estado_ingreso_primer_numero, no_operation},
-                                {TIMEOUT_DEFAULT, estado_puerta_cerrada, reset_FSM},
-                                {FIN_TABLA, estado_validando_pin, no_operation}};
-
-/*** estado_7 ***/
-STATE estado_puerta_abierta[] = {
-    {TIMEOUT_DEFAULT, estado_puerta_cerrada,
-     cerrar_puerta}, // este es el unico en el que timeout cumple un sentido logico, por eso no
-                     // anula todos los comportamientos como en los otros
-    {FIN_TABLA, estado_puerta_abierta, no_operation} // Cambiar despues
-};
+FSM_TABLA(FSM_TABLA_ESTADO, FSM_TABLA_ARCO, FSM_TABLA_FIN)
 
 #endif /* API_INC_FSM_TABLE_H_ */
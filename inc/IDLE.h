@@ -0,0 +1,40 @@
+/*
+ * IDLE.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_IDLE_H_
+#define API_INC_IDLE_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/*El lector de tarjetas y el teclado se leen por encuesta, asi que nunca se duerme mas que esto*/
+#ifndef IDLE_MAX_SLEEP_US
+#define IDLE_MAX_SLEEP_US 20000U
+#endif
+
+/*Ventana sobre la que se calculan el ciclo util y los despertares por segundo*/
+#ifndef IDLE_STATS_WINDOW_US
+#define IDLE_STATS_WINDOW_US 1000000U
+#endif
+
+#define IDLE_MAX_FDS 4
+
+typedef struct {
+    uint32_t despertares;         // Total desde IDLE_Init
+    uint32_t ventanas;            // Ventanas de medicion cerradas
+    uint16_t ciclo_util_permil;   // Tiempo despierto en la ultima ventana, en milesimas
+    uint16_t despertares_por_seg; // En la ultima ventana
+} idle_stats;
+
+void IDLE_Init(uint32_t (*reloj_us)(void), bool (*hay_trabajo)(void));
+bool IDLE_Sleep(void);
+const idle_stats * IDLE_GetStats(void);
+
+#ifdef __linux__
+void IDLE_WatchFd(int fd);
+#endif
+
+#endif /* API_INC_IDLE_H_ */
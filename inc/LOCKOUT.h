@@ -0,0 +1,37 @@
+/*
+ * LOCKOUT.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_LOCKOUT_H_
+#define API_INC_LOCKOUT_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Bloqueo por PIN incorrecto. Despues de unos fallos seguidos libres cada fallo nuevo bloquea por
+ * el doble de tiempo que el anterior, hasta un tope. Se cuenta por tarjeta y por puerta: la
+ * puerta frena a quien prueba con muchas tarjetas distintas*/
+#define LOCKOUT_MAX_CARDS          32 // Tarjetas con fallos recientes, se desaloja la menos usada
+#define LOCKOUT_FREE_FAILURES      3
+#define LOCKOUT_BASE_MS            30000U
+#define LOCKOUT_MAX_MS             900000U  // 15 minutos
+#define LOCKOUT_DOOR_FREE_FAILURES 10
+#define LOCKOUT_DOOR_BASE_MS       60000U
+#define LOCKOUT_FORGET_MS          3600000U // Sin fallos durante una hora se empieza de cero
+
+typedef struct {
+    uint32_t rechazos;   // Tarjetas que no pudieron ingresar el PIN
+    uint32_t bloqueos;   // Fallos que dejaron bloqueada una tarjeta o la puerta
+    uint32_t desalojos;  // Tarjetas con fallos que se olvidaron por falta de lugar
+} lockout_stats;
+
+void LOCKOUT_Init(uint32_t (*reloj_ms)(void));
+bool LOCKOUT_Allowed(const uint8_t * uid);
+bool LOCKOUT_RecordFailure(const uint8_t * uid);
+void LOCKOUT_RecordSuccess(const uint8_t * uid);
+uint32_t LOCKOUT_RemainingMs(const uint8_t * uid);
+const lockout_stats * LOCKOUT_GetStats(void);
+
+#endif /* API_INC_LOCKOUT_H_ */
@@ -0,0 +1,64 @@
+/*
+ * METRICS.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_METRICS_H_
+#define API_INC_METRICS_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "FSM.h"
+
+/*Contadores monotonos de 32 bits, el colector calcula las tasas con la diferencia entre dos
+ * tramas. Se pueden incrementar desde interrupciones*/
+#define METRIC_TRANSITION(estado) (METRIC_TRANSITIONS_BASE + (estado)) // Arcos tomados por origen
+#define METRIC_EVENT(evento)      (METRIC_EVENTS_BASE + (evento))
+
+typedef enum {
+    METRIC_TRANSITIONS_BASE = 0,
+    METRIC_EVENTS_BASE = METRIC_TRANSITIONS_BASE + FSM_MAX_ESTADOS,
+    METRIC_RC522_TIMEOUTS = METRIC_EVENTS_BASE + FIN_TABLA, // Comandos sin respuesta de la tarjeta
+    METRIC_LOOP_ITERATIONS,
+    METRIC_LOCKOUT_REJECTS,     // Tarjetas rechazadas por PIN incorrecto repetido
+    METRICS_COUNTERS
+} metric_counter;
+
+/*Histogramas con cubetas de potencias de 2: la cubeta b cuenta los valores en [2^(b-1), 2^b)*/
+#define METRICS_BUCKETS 16
+
+typedef enum {
+    METRIC_HIST_LOOP_US,      // Duracion de cada vuelta del lazo principal (sin el reposo)
+    METRIC_HIST_CARD_READ_US, // Lectura de credenciales MIFARE
+    METRICS_HISTOGRAMS
+} metric_histogram;
+
+/*Trama de exportacion, enteros little endian:
+ * "TSSM" | version u8 | contadores u8 | histogramas u8 | cubetas u8 | secuencia u32 | ms u32 |
+ * contadores u32[] | cubetas u32[histogramas][cubetas] | CRC-32 de todo lo anterior*/
+#define METRICS_FRAME_MAGIC   "TSSM"
+#define METRICS_FRAME_VERSION 2
+#define METRICS_HEADER_LEN    16
+#define METRICS_FRAME_LEN                                                                          \
+    (METRICS_HEADER_LEN + 4 * (METRICS_COUNTERS + METRICS_HISTOGRAMS * METRICS_BUCKETS) + 4)
+
+/*Salida de las tramas. Con pedido == NULL se envia una cada METRICS_EXPORT_PERIOD_MS (UART), si
+ * no se responde cada vez que el colector la pide (socket en Linux)*/
+#define METRICS_EXPORT_PERIOD_MS 1000U
+
+typedef struct {
+    bool (*pedido)(void);
+    void (*enviar)(const uint8_t * trama, uint16_t largo);
+} metrics_sink;
+
+void METRICS_Init(const metrics_sink * sink);
+void METRICS_Inc(metric_counter contador);
+void METRICS_Add(metric_counter contador, uint32_t cantidad);
+void METRICS_Observe(metric_histogram histograma, uint32_t valor);
+uint32_t METRICS_GetCounter(metric_counter contador);
+uint32_t METRICS_GetBucket(metric_histogram histograma, uint8_t cubeta);
+uint16_t METRICS_BuildFrame(uint8_t * trama, uint16_t largo, uint32_t now_ms);
+void METRICS_Service(uint32_t now_ms);
+
+#endif /* API_INC_METRICS_H_ */
@@ -0,0 +1,18 @@
+/*
+ * METRICS_UNIX.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_METRICS_UNIX_H_
+#define API_INC_METRICS_UNIX_H_
+#include "METRICS.h"
+
+/*Salida para simulacion en Linux: socket Unix SOCK_DGRAM. El colector se bindea a su propia
+ * direccion, envia cualquier datagrama y recibe una trama como respuesta*/
+const metrics_sink * METRICS_UNIX_Open(const char * path);
+int METRICS_UNIX_GetFd(void);
+void METRICS_UNIX_Close(void);
+
+#endif /* API_INC_METRICS_UNIX_H_ */
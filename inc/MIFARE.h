@@ -0,0 +1,64 @@
+/*
+ * MIFARE.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_MIFARE_H_
+#define API_INC_MIFARE_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MIFARE_UID_LEN         4
+#define MIFARE_KEY_LEN         6
+#define MIFARE_BLOCK_SIZE      16
+#define MIFARE_SECTORS         16 // MIFARE Classic 1K
+#define MIFARE_BLOCKS_PER_SECT 4  // El ultimo es el trailer con las claves, no se lee
+#define MIFARE_DATA_BLOCKS     (MIFARE_BLOCKS_PER_SECT - 1)
+
+typedef enum {
+    MIFARE_OK,
+    MIFARE_NO_TAG,   // Nadie respondio antes del timeout del lector
+    MIFARE_ERR,      // Respuesta invalida, colision o error de CRC
+    MIFARE_AUTH_ERR  // La clave no corresponde al sector
+} mifare_status;
+
+/*Lector (PCD). La implementacion sobre el RC522 esta en MIFARE_RC522*/
+typedef struct {
+    /*Envia tx y espera la respuesta. bits_finales: bits validos del ultimo byte (0 = 8). Con crc el
+     * lector agrega el CRC al enviar y lo verifica y quita al recibir. rx puede ser NULL*/
+    mifare_status (*transceive)(const uint8_t * tx, uint8_t tx_len, uint8_t bits_finales, bool crc,
+                                uint8_t * rx, uint8_t * rx_len);
+    mifare_status (*authenticate)(uint8_t modo, uint8_t bloque, const uint8_t * clave,
+                                  const uint8_t * uid);
+    /*Deja el lector como lo espera el resto del firmware: el REQA de get_RFID_event_ocurrence va
+     * sin CRC y sin cifrar. Se llama al terminar cada operacion de alto nivel*/
+    void (*release)(void);
+} mifare_pcd;
+
+typedef struct {
+    uint32_t lecturas;  // Credenciales leidas con exito
+    uint32_t fallidas;
+    uint32_t ultima_us; // Request + anticolision + select + auth + bloques
+    uint32_t maxima_us;
+} mifare_stats;
+
+void MIFARE_Init(const mifare_pcd * pcd, uint32_t (*reloj_us)(void));
+
+/*Comandos ISO 14443A / MIFARE Classic sueltos*/
+mifare_status MIFARE_Request(uint8_t modo, uint8_t * atqa);
+mifare_status MIFARE_Anticoll(uint8_t * uid_bcc);
+mifare_status MIFARE_SelectTag(const uint8_t * uid_bcc, uint8_t * sak);
+mifare_status MIFARE_Auth(uint8_t modo, uint8_t bloque, const uint8_t * clave,
+                          const uint8_t * uid);
+mifare_status MIFARE_Read(uint8_t bloque, uint8_t * datos);
+void MIFARE_Halt(void);
+
+/*Credencial guardada en bloques de datos de un sector, autenticando con la clave A. Todavia no hay
+ * un formato de credencial en tarjeta: el firmware valida solo el UID y no llama a esta funcion*/
+mifare_status MIFARE_ReadCredential(uint8_t sector, uint8_t primero, uint8_t cantidad,
+                                    const uint8_t * clave, uint8_t * uid, uint8_t * datos);
+const mifare_stats * MIFARE_GetStats(void);
+
+#endif /* API_INC_MIFARE_H_ */
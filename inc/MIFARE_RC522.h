@@ -0,0 +1,19 @@
+/*
+ * MIFARE_RC522.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_MIFARE_RC522_H_
+#define API_INC_MIFARE_RC522_H_
+#include "MIFARE.h"
+
+/*Consultas a CommIrqReg antes de abandonar un comando. El timer interno del RC522 (configurado por
+ * MFRC522_Init) corta antes si la tarjeta no responde*/
+#define MIFARE_RC522_MAX_POLLS 2000
+
+/*Lector MIFARE sobre el RC522 por SPI. Se llama despues de MFRC522_Init*/
+const mifare_pcd * MIFARE_RC522_Init(void);
+
+#endif /* API_INC_MIFARE_RC522_H_ */
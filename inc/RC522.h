@@ -138,6 +138,7 @@
 //-----------------------------------------------
 // The desire to use
 void MFRC522_Init(void);
+// Request, anticolision, select, auth y lectura de bloques: ver MIFARE.h
 // uint8_t MFRC522_Request(uint8_t reqMode, uint8_t *TagType);
 // uint8_t MFRC522_Anticoll(uint8_t *serNum);
 // uint8_t MFRC522_SelectTag(uint8_t *serNum);
@@ -0,0 +1,63 @@
+/*
+ * TASKS.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_TASKS_H_
+#define API_INC_TASKS_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Corrutinas sin pila (estilo protothreads) para las rutinas de accion que tienen que esperar
+ * algo lento sin frenar al resto del lazo. Solo se conserva la linea en la que se cedio: las
+ * variables que tengan que sobrevivir a una espera deben ser static. No se puede ceder desde
+ * adentro de un switch propio*/
+#define TASKS_MAX 4
+
+typedef enum {
+    TASK_WAITING, // Bloqueada en TASK_WAIT_UNTIL
+    TASK_YIELDED, // Cedio el procesador pero puede seguir
+    TASK_ENDED
+} task_result;
+
+typedef struct {
+    uint16_t linea;
+} task_ctx;
+
+typedef task_result (*task_fn)(task_ctx * ctx);
+
+#define TASK_BEGIN(ctx)                                                                            \
+    switch ((ctx)->linea) {                                                                        \
+    case 0:
+
+#define TASK_YIELD(ctx)                                                                            \
+    do {                                                                                           \
+        (ctx)->linea = __LINE__;                                                                   \
+        return TASK_YIELDED;                                                                       \
+    case __LINE__:;                                                                                \
+    } while (0)
+
+#define TASK_WAIT_UNTIL(ctx, condicion)                                                            \
+    do {                                                                                           \
+        (ctx)->linea = __LINE__;                                                                   \
+    case __LINE__:                                                                                 \
+        if (!(condicion)) {                                                                        \
+            return TASK_WAITING;                                                                   \
+        }                                                                                          \
+    } while (0)
+
+#define TASK_END(ctx)                                                                              \
+    }                                                                                              \
+    (ctx)->linea = 0;                                                                              \
+    return TASK_ENDED
+
+void TASKS_Init(uint32_t (*reloj_us)(void));
+bool TASKS_Start(task_fn tarea);
+void TASKS_Cancel(task_fn tarea);
+uint8_t TASKS_Run(uint32_t presupuesto_us);
+uint8_t TASKS_Ready(void);
+uint8_t TASKS_Pending(void);
+
+#endif /* API_INC_TASKS_H_ */
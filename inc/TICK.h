@@ -0,0 +1,16 @@
+/*
+ * TICK.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_TICK_H_
+#define API_INC_TICK_H_
+#include <stdint.h>
+
+/*Base de tiempo monotona del sistema (HAL_GetTick en el target, CLOCK_MONOTONIC en Linux)*/
+uint32_t TICK_GetMs(void);
+uint32_t TICK_GetUs(void);
+
+#endif /* API_INC_TICK_H_ */
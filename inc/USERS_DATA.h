@@ -14,6 +14,7 @@ typedef uint8_t KeyCard[4];
 typedef uint8_t PIN[4];
 
 #define MAX_USERS 10
+#define USERS_DATA_NO_USER_ID 0xFFFFFFFFU // Tarjeta aceptada por el servidor sin registro local
 
 typedef struct {
     KeyCard UserKeyCard;
@@ -23,6 +24,8 @@ typedef struct {
 void USERS_DATA_INIT(void);
 bool USERS_DATA_VALIDATE_KEYCARD(uint8_t * KeyCardReaded);
 bool USERS_DATA_VALIDATE_PIN(void);
+uint32_t USERS_DATA_GET_CURRENT_USER_ID(void);
+bool USERS_DATA_KEYCARD_PENDING(void);
 
 void USERS_DATA_COLLECT_FIRST_NUMBER(uint8_t * PIN_FirstNumber);
 void USERS_DATA_COLLECT_SECOND_NUMBER(uint8_t * PIN_SecondNumber);
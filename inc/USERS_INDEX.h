@@ -0,0 +1,60 @@
+/*
+ * USERS_INDEX.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_USERS_INDEX_H_
+#define API_INC_USERS_INDEX_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include "USERS_DATA.h"
+
+/*Capacidad de cada una de las dos copias del indice (la activa y la que se esta armando)*/
+#ifndef USERS_INDEX_MAX_ENTRIES
+#define USERS_INDEX_MAX_ENTRIES 256
+#endif
+/*Hasta esta cantidad de usuarios la busqueda es lineal (vectorizada), por encima es binaria*/
+#define USERS_INDEX_LINEAR_MAX 64
+/*Tarjetas que se resuelven por cada lectura del indice en USERS_INDEX_LookupBatch*/
+#define USERS_INDEX_BATCH      64
+
+/*Formato del delta (little endian):
+ *  cabecera: "UDLT" | version base (u32) | version nueva (u32) | cantidad de registros (u32)
+ *  registro: operacion (u8) | UID (4) | PIN (4) | id de usuario (u32)
+ * Los registros deben venir ordenados por UID (memcmp) y sin UID repetidos, y la version nueva
+ * tiene que ser mayor que la base. El canal que trae los deltas al equipo no esta en este arbol*/
+#define USERS_DELTA_MAGIC       "UDLT"
+#define USERS_DELTA_HEADER_LEN  16
+#define USERS_DELTA_RECORD_LEN  13
+
+typedef enum {
+    USERS_DELTA_ADD,
+    USERS_DELTA_REMOVE,
+    USERS_DELTA_MODIFY
+} users_delta_op;
+
+typedef enum {
+    USERS_SYNC_IDLE,  // No hay delta en curso
+    USERS_SYNC_BUSY,  // Hay que seguir llamando a USERS_INDEX_SyncStep
+    USERS_SYNC_DONE,  // La nueva version ya esta publicada
+    USERS_SYNC_ERROR  // Delta rechazado, se sigue usando la version anterior
+} users_sync_status;
+
+typedef struct {
+    KeyCard UserKeyCard;
+    PIN UserPin;
+    uint32_t UserId;
+} users_entry;
+
+void USERS_INDEX_Init(const user * usuarios, uint32_t cantidad);
+bool USERS_INDEX_Lookup(const uint8_t * KeyCardReaded, users_entry * encontrado);
+void USERS_INDEX_LookupBatch(const KeyCard * tarjetas, uint32_t cantidad, bool * presentes);
+uint32_t USERS_INDEX_GetVersion(void);
+uint32_t USERS_INDEX_GetCount(void);
+
+users_sync_status USERS_INDEX_BeginDelta(const uint8_t * delta, uint32_t len);
+users_sync_status USERS_INDEX_SyncStep(uint32_t budget);
+
+#endif /* API_INC_USERS_INDEX_H_ */
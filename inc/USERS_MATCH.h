@@ -0,0 +1,27 @@
+/*
+ * USERS_MATCH.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_USERS_MATCH_H_
+#define API_INC_USERS_MATCH_H_
+#include <stdint.h>
+
+/*Comparacion de un UID contra una columna contigua de UIDs empaquetados en 32 bits.
+ * Usa AVX2/SSE2 en x86, NEON o Helium (MVE) en ARM y una version escalar en el resto*/
+
+#define USERS_MATCH_NOT_FOUND (-1)
+/*Cantidad de UIDs de la columna que se recorren por bloque en las busquedas por lote*/
+#define USERS_MATCH_BLOCK     4096U
+
+void USERS_MATCH_Init(void);
+uint32_t USERS_MATCH_PackUid(const uint8_t * uid);
+int32_t USERS_MATCH_Find(const uint32_t * columna, uint32_t cantidad, uint32_t uid);
+int32_t USERS_MATCH_FindScalar(const uint32_t * columna, uint32_t cantidad, uint32_t uid);
+void USERS_MATCH_Batch(const uint32_t * columna, uint32_t cantidad, const uint32_t * uids,
+                       uint32_t cantidad_uids, int32_t * posiciones);
+const char * USERS_MATCH_GetImplementation(void);
+
+#endif /* API_INC_USERS_MATCH_H_ */
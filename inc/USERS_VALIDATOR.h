@@ -0,0 +1,41 @@
+/*
+ * USERS_VALIDATOR.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_USERS_VALIDATOR_H_
+#define API_INC_USERS_VALIDATOR_H_
+#include <stdint.h>
+#include <stdbool.h>
+
+/*Cantidad de decisiones que se recuerdan (se descarta la menos usada recientemente)*/
+#define VALIDATOR_CACHE_SIZE          16
+/*Vida util de una decision positiva y negativa, pasado este tiempo se vuelve a consultar*/
+#define VALIDATOR_TTL_MS              60000U
+#define VALIDATOR_NEGATIVE_TTL_MS     10000U
+/*Edad a partir de la cual una decision vigente se refresca en segundo plano, antes de su TTL*/
+#define VALIDATOR_REFRESH_MS          45000U
+#define VALIDATOR_NEGATIVE_REFRESH_MS 7500U
+/*Si el servidor no responde en este tiempo la consulta se da por perdida*/
+#define VALIDATOR_RESPONSE_TIMEOUT_MS 300U
+
+typedef enum {
+    VALIDATOR_DENY,
+    VALIDATOR_ALLOW,
+    VALIDATOR_UNKNOWN // Sin decision todavia, se debe usar la tabla local
+} validator_verdict;
+
+/*Servicio remoto de credenciales. Ninguna de las dos operaciones puede bloquear*/
+typedef struct {
+    bool (*request)(const uint8_t * uid);                                  // Envia una consulta
+    bool (*poll)(uint8_t * uid, validator_verdict * verdict, uint8_t * pin); // Lee una respuesta
+} users_validator_backend;
+
+void USERS_VALIDATOR_Init(const users_validator_backend * backend);
+validator_verdict USERS_VALIDATOR_Lookup(const uint8_t * uid, uint8_t * pin, uint32_t now);
+void USERS_VALIDATOR_Poll(uint32_t now);
+bool USERS_VALIDATOR_Pending(const uint8_t * uid);
+
+#endif /* API_INC_USERS_VALIDATOR_H_ */
@@ -0,0 +1,23 @@
+/*
+ * USERS_VALIDATOR_UNIX.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifndef API_INC_USERS_VALIDATOR_UNIX_H_
+#define API_INC_USERS_VALIDATOR_UNIX_H_
+#include "USERS_VALIDATOR.h"
+
+/*Backend para simulacion en Linux: el servidor de credenciales escucha en un socket Unix
+ * SOCK_SEQPACKET. Consulta: UID (4 bytes). Respuesta: UID (4) + decision (1) + PIN (4).
+ * Sus respuestas abren la puerta, asi que solo se acepta un servidor que corra como root*/
+#define VALIDATOR_UNIX_REQUEST_LEN  4
+#define VALIDATOR_UNIX_RESPONSE_LEN 9
+#define VALIDATOR_UNIX_SERVER_UID   0
+
+const users_validator_backend * USERS_VALIDATOR_UNIX_Open(const char * path);
+int USERS_VALIDATOR_UNIX_GetFd(void);
+void USERS_VALIDATOR_UNIX_Close(void);
+
+#endif /* API_INC_USERS_VALIDATOR_UNIX_H_ */
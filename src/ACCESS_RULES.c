@@ -0,0 +1,245 @@
+/*
+ * ACCESS_RULES.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "ACCESS_RULES.h"
+#include <string.h>
+
+#define REGLA_FERIADOS 0x01U // Puede entrar los dias feriados
+#define REGLA_MOVIDA   0x02U // Ya tiene su id nuevo (solo durante ACCESS_RULES_Renumber)
+#define REGLA_BORRADA  0x04U // Horario viejo del id nuevo (solo durante ACCESS_RULES_Renumber)
+
+#define CUBETAS (2U * ACCESS_RULES_MAX_USERS) // Tabla de dispersion ocupada a lo sumo a la mitad
+#define LIBRE   0U
+
+typedef struct {
+    uint32_t user_id;
+    uint8_t semana[ACCESS_RULES_WEEK_BYTES]; // Un bit por slot, empezando el lunes 00:00
+    uint8_t marcas;
+    uint16_t grupos; // Grupos de puertas habilitados
+} access_user_rules;
+
+/*Los ids de usuario son de 32 bits (los deltas traen ids arbitrarios), asi que los horarios se
+ * guardan densos en reglas[] y una tabla de dispersion con sondeo lineal lleva del id a su
+ * posicion. Un usuario que no esta en la tabla no tiene horario*/
+static access_user_rules reglas[ACCESS_RULES_MAX_USERS];
+static uint32_t usados;
+static uint32_t cubetas[CUBETAS]; // Posicion en reglas[] mas uno, LIBRE (cero) si esta vacia
+static uint8_t feriados[(366 + 7) / 8];
+
+static uint16_t grupo_de_esta_puerta;
+/*Precalculado en ACCESS_RULES_SetTime para que el chequeo sean solo operaciones de bits*/
+static uint16_t byte_actual;
+static uint8_t mascara_actual;
+static bool feriado_hoy;
+static bool hora_conocida; // Hubo al menos un ACCESS_RULES_SetTime desde ACCESS_RULES_Init
+
+/*Reduccion multiplicativa: lleva el hash a [0, CUBETAS) sin dividir*/
+static uint32_t cubeta_de(uint32_t user_id) {
+    return (uint32_t)(((uint64_t)(user_id * 2654435761U) * CUBETAS) >> 32);
+}
+
+static uint32_t siguiente(uint32_t cubeta) {
+    return cubeta + 1 == CUBETAS ? 0 : cubeta + 1;
+}
+
+/*Devuelve la cubeta del usuario, o la cubeta libre donde iria*/
+static uint32_t buscar(uint32_t user_id) {
+    uint32_t i = cubeta_de(user_id);
+    while (cubetas[i] != LIBRE && reglas[cubetas[i] - 1].user_id != user_id) {
+        i = siguiente(i);
+    }
+    return i;
+}
+
+/*Borrado sin marcas: se corren hacia atras las entradas de la misma racha que quedarian
+ * inalcanzables desde su cubeta de origen*/
+static void liberar_cubeta(uint32_t libre) {
+    uint32_t j = libre;
+    for (;;) {
+        j = siguiente(j);
+        if (cubetas[j] == LIBRE) {
+            break;
+        }
+        uint32_t origen = cubeta_de(reglas[cubetas[j] - 1].user_id);
+        bool alcanzable = libre <= j ? (libre < origen && origen <= j)
+                                     : (libre < origen || origen <= j);
+        if (!alcanzable) {
+            cubetas[libre] = cubetas[j];
+            libre = j;
+        }
+    }
+    cubetas[libre] = LIBRE;
+}
+
+static void habilitar_slots(access_user_rules * regla, uint16_t primero, uint16_t ultimo) {
+    for (uint16_t slot = primero; slot < ultimo; slot++) {
+        uint16_t s = slot % ACCESS_RULES_WEEK_SLOTS;
+        regla->semana[s >> 3] |= (uint8_t)(1U << (s & 7));
+    }
+}
+
+void ACCESS_RULES_Init(uint16_t grupo_puerta) {
+    memset(reglas, 0, sizeof(reglas));
+    memset(cubetas, LIBRE, sizeof(cubetas));
+    usados = 0;
+    memset(feriados, 0, sizeof(feriados));
+    grupo_de_esta_puerta = grupo_puerta;
+    ACCESS_RULES_SetTime(0, 0, 0);
+    hora_conocida = false;
+}
+
+/*Devuelve false si alguna ventana es invalida o si no queda lugar para un usuario nuevo. En los
+ * dos casos el usuario conserva el horario que tenia*/
+bool ACCESS_RULES_Compile(uint32_t user_id, const access_window * ventanas, uint8_t cantidad,
+                          uint16_t grupos, bool feriados_permitidos) {
+    for (uint8_t i = 0; i < cantidad; i++) {
+        if (ventanas[i].desde >= 1440 || ventanas[i].hasta > 1440) {
+            return false; // Se conserva el horario anterior
+        }
+    }
+
+    uint32_t cubeta = buscar(user_id);
+    if (cubetas[cubeta] == LIBRE) {
+        if (usados == ACCESS_RULES_MAX_USERS) {
+            return false;
+        }
+        cubetas[cubeta] = ++usados;
+    }
+
+    access_user_rules * regla = &reglas[cubetas[cubeta] - 1];
+    memset(regla, 0, sizeof(*regla));
+    regla->user_id = user_id;
+
+    for (uint8_t i = 0; i < cantidad; i++) {
+        const access_window * v = &ventanas[i];
+        uint16_t primero = (v->desde + ACCESS_RULES_SLOT_MINUTES - 1) / ACCESS_RULES_SLOT_MINUTES;
+        uint16_t ultimo = v->hasta / ACCESS_RULES_SLOT_MINUTES;
+        if (v->hasta < v->desde) {
+            ultimo += ACCESS_RULES_SLOTS_PER_DAY; // Cruza la medianoche
+        }
+        for (uint8_t dia = 0; dia < 7; dia++) {
+            if (v->dias & (1U << dia)) {
+                uint16_t base = dia * ACCESS_RULES_SLOTS_PER_DAY;
+                habilitar_slots(regla, base + primero, base + ultimo);
+            }
+        }
+    }
+
+    regla->grupos = grupos;
+    regla->marcas = feriados_permitidos ? REGLA_FERIADOS : 0;
+    return true;
+}
+
+/*El ultimo horario ocupa el lugar del que se borra, asi reglas[] sigue denso*/
+void ACCESS_RULES_Remove(uint32_t user_id) {
+    uint32_t cubeta = buscar(user_id);
+    if (cubetas[cubeta] == LIBRE) {
+        return;
+    }
+
+    uint32_t posicion = cubetas[cubeta] - 1;
+    uint32_t ultimo = --usados;
+    liberar_cubeta(cubeta);
+    if (posicion != ultimo) {
+        reglas[posicion] = reglas[ultimo];
+        cubetas[buscar(reglas[posicion].user_id)] = posicion + 1;
+    }
+}
+
+/*Horario sin marcar de user_id, o NULL. Recorre reglas[] porque mientras se renumera la tabla de
+ * dispersion no coincide con los ids*/
+static access_user_rules * buscar_sin_marcar(uint32_t user_id) {
+    for (uint32_t i = 0; i < usados; i++) {
+        if (reglas[i].user_id == user_id && !(reglas[i].marcas & (REGLA_MOVIDA | REGLA_BORRADA))) {
+            return &reglas[i];
+        }
+    }
+    return NULL;
+}
+
+/*Compacta reglas[] sin los horarios borrados y vuelve a armar la tabla de dispersion*/
+static void reconstruir(void) {
+    uint32_t cantidad = usados;
+    usados = 0;
+    memset(cubetas, LIBRE, sizeof(cubetas));
+    for (uint32_t i = 0; i < cantidad; i++) {
+        if (reglas[i].marcas & REGLA_BORRADA) {
+            continue;
+        }
+        uint32_t cubeta = buscar(reglas[i].user_id);
+        if (cubetas[cubeta] != LIBRE) {
+            continue; // Dos ids viejos renumerados al mismo: queda el primero
+        }
+        reglas[usados] = reglas[i];
+        reglas[usados].marcas &= (uint8_t)~REGLA_MOVIDA;
+        cubetas[cubeta] = ++usados;
+    }
+}
+
+/*Todos los cambios se aplican a la vez, asi que admite intercambios y cadenas (1->2, 2->3). Un id
+ * nuevo que ya tenia horario y no es el destino de nadie con horario lo pierde: el usuario
+ * renumerado no hereda el horario de otro*/
+void ACCESS_RULES_Renumber(const access_id_change * cambios, uint32_t cantidad) {
+    if (cantidad == 0) {
+        return;
+    }
+    for (uint32_t i = 0; i < cantidad; i++) {
+        access_user_rules * regla = buscar_sin_marcar(cambios[i].viejo);
+        if (regla != NULL) {
+            regla->user_id = cambios[i].nuevo;
+            regla->marcas |= REGLA_MOVIDA;
+        }
+    }
+    for (uint32_t i = 0; i < cantidad; i++) {
+        access_user_rules * regla = buscar_sin_marcar(cambios[i].nuevo);
+        if (regla != NULL) {
+            regla->marcas |= REGLA_BORRADA;
+        }
+    }
+    reconstruir();
+}
+
+void ACCESS_RULES_SetHoliday(uint16_t dia_del_anio, bool feriado) {
+    if (dia_del_anio >= 366) {
+        return;
+    }
+    if (feriado) {
+        feriados[dia_del_anio >> 3] |= (uint8_t)(1U << (dia_del_anio & 7));
+    } else {
+        feriados[dia_del_anio >> 3] &= (uint8_t)~(1U << (dia_del_anio & 7));
+    }
+}
+
+/*dia_semana: 0 = lunes. Se llama desde el RTC al cambiar de slot o de dia*/
+void ACCESS_RULES_SetTime(uint8_t dia_semana, uint16_t minuto_del_dia, uint16_t dia_del_anio) {
+    uint16_t slot = (uint16_t)((dia_semana % 7) * ACCESS_RULES_SLOTS_PER_DAY +
+                               (minuto_del_dia % 1440) / ACCESS_RULES_SLOT_MINUTES);
+    byte_actual = slot >> 3;
+    mascara_actual = (uint8_t)(1U << (slot & 7));
+    feriado_hoy = dia_del_anio < 366 && (feriados[dia_del_anio >> 3] >> (dia_del_anio & 7)) & 1U;
+    hora_conocida = true;
+}
+
+/*Los usuarios sin horario cargado (o sin id local, validados solo por el servidor) no tienen
+ * restricciones, igual que antes de existir este modulo. Los que tienen horario no entran mientras
+ * no se sepa la hora*/
+bool ACCESS_RULES_Check(uint32_t user_id) {
+    uint32_t cubeta = buscar(user_id);
+    if (cubetas[cubeta] == LIBRE) {
+        return true;
+    }
+
+    const access_user_rules * regla = &reglas[cubetas[cubeta] - 1];
+    return hora_conocida && (regla->semana[byte_actual] & mascara_actual) &&
+           (regla->grupos & grupo_de_esta_puerta) &&
+           (!feriado_hoy || (regla->marcas & REGLA_FERIADOS));
+}
+
+/*Incluye las dos cubetas que le tocan a cada usuario en la tabla de dispersion*/
+uint32_t ACCESS_RULES_GetBytesPerUser(void) {
+    return sizeof(access_user_rules) + 2U * sizeof(cubetas[0]);
+}
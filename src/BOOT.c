@@ -0,0 +1,75 @@
+/*
+ * BOOT.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "BOOT.h"
+#include <stddef.h>
+#include <string.h>
+
+static const boot_stage * etapas;
+static uint8_t cantidad_etapas;
+static uint32_t (*reloj)(void);
+static uint32_t inicio_arranque;
+static uint32_t listas; // Mascara BOOT_STAGE()
+static boot_timeline_entry linea_de_tiempo[BOOT_MAX_STAGES];
+
+static uint32_t ahora(void) {
+    return reloj() - inicio_arranque;
+}
+
+/*Una pasada sobre las etapas del grupo pedido. Devuelve true si todas quedaron listas*/
+static bool avanzar(bool diferidas) {
+    bool completo = true;
+
+    for (uint8_t i = 0; i < cantidad_etapas; i++) {
+        const boot_stage * etapa = &etapas[i];
+        if (etapa->diferida != diferidas || (listas & BOOT_STAGE(i))) {
+            continue;
+        }
+        if ((etapa->dependencias & listas) != etapa->dependencias) {
+            completo = false;
+            continue;
+        }
+        linea_de_tiempo[i].inicio_us = ahora();
+        if (etapa->iniciar != NULL) {
+            etapa->iniciar();
+        }
+        listas |= BOOT_STAGE(i);
+        linea_de_tiempo[i].lista_us = ahora();
+    }
+    return completo;
+}
+
+void BOOT_Init(const boot_stage * tabla, uint8_t cantidad, uint32_t (*reloj_us)(void)) {
+    etapas = tabla;
+    cantidad_etapas = cantidad < BOOT_MAX_STAGES ? cantidad : BOOT_MAX_STAGES;
+    reloj = reloj_us;
+    inicio_arranque = reloj();
+    listas = 0;
+    memset(linea_de_tiempo, 0, sizeof(linea_de_tiempo));
+}
+
+/*La etapa no hace falta (por ejemplo el RC522 en un arranque en caliente)*/
+void BOOT_Skip(uint8_t etapa) {
+    if (etapa < cantidad_etapas) {
+        listas |= BOOT_STAGE(etapa);
+        linea_de_tiempo[etapa].omitida = true;
+    }
+}
+
+/*Etapas criticas: devuelve true cuando la FSM ya puede empezar a recibir eventos*/
+bool BOOT_Step(void) {
+    return avanzar(false);
+}
+
+/*Etapas diferidas: se llama desde el lazo principal hasta que devuelve true*/
+bool BOOT_StepDeferred(void) {
+    return avanzar(true);
+}
+
+const boot_timeline_entry * BOOT_GetTimeline(void) {
+    return linea_de_tiempo;
+}
@@ -0,0 +1,42 @@
+/*
+ * BYTES.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "BYTES.h"
+
+/*Bit a bit, sin tabla: los bloques son de unos cientos de bytes y asi no ocupa 1 KiB de flash*/
+uint32_t BYTES_Crc32(const uint8_t * datos, size_t largo) {
+    uint32_t crc = 0xFFFFFFFFU;
+    while (largo--) {
+        crc ^= *datos++;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1U)));
+        }
+    }
+    return ~crc;
+}
+
+uint8_t * BYTES_PutU16(uint8_t * p, uint16_t valor) {
+    p[0] = (uint8_t)valor;
+    p[1] = (uint8_t)(valor >> 8);
+    return p + 2;
+}
+
+uint8_t * BYTES_PutU32(uint8_t * p, uint32_t valor) {
+    p[0] = (uint8_t)valor;
+    p[1] = (uint8_t)(valor >> 8);
+    p[2] = (uint8_t)(valor >> 16);
+    p[3] = (uint8_t)(valor >> 24);
+    return p + 4;
+}
+
+uint16_t BYTES_GetU16(const uint8_t * p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+uint32_t BYTES_GetU32(const uint8_t * p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
@@ -8,30 +8,146 @@
 #include "FSM.h"
 #include "FSM_Table.h"
 #include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 #include "RC522.h"
 #include "TTP229.h"
 #include "USERS_DATA.h"
 #include "TIMER.h"
 #include "LED.h"
+#include "ACCESS_RULES.h"
+#include "TASKS.h"
+#include "METRICS.h"
+#include "LOCKOUT.h"
 
 static int tarjetavalida = 0;
 static uint8_t NumeroPulsado = -1;
 static int pinValido = 0;
+static bool timeout_activo = false;
+static bool sesion_bloqueada = false; // El PIN incorrecto bloqueo la tarjeta o la puerta
+static KeyCard tarjeta_actual;         // Tarjeta de la sesion, para contar sus fallos de PIN
 
-STATE * FSM_GetInitState(void) {
+#define NADA(...)
+#define ID_ESTADO(estado)      ID_##estado,
+#define PUNTERO_ESTADO(estado) estado,
 
-    STATE * initialState = estado_puerta_cerrada;
+/*Orden fijo de los estados, el de FSM_Table.h. Su posicion es el id que se guarda en la RAM
+ * retenida*/
+enum { FSM_TABLA(ID_ESTADO, NADA, NADA) ESTADOS_COMPILADOS };
+_Static_assert(ESTADOS_COMPILADOS == FSM_CANTIDAD_ESTADOS, "FSM_CANTIDAD_ESTADOS desactualizado");
+
+static const STATE * const estados[FSM_CANTIDAD_ESTADOS] = {FSM_TABLA(PUNTERO_ESTADO, NADA, NADA)};
+
+static const fsm_tablas tablas_compiladas = {estados, FSM_CANTIDAD_ESTADOS, FSM_TABLE_VERSION};
+static const fsm_tablas * activas = &tablas_compiladas;
+
+const STATE * FSM_GetInitState(void) {
+
+    const STATE * initialState = activas->estados[0];
     return initialState; // El sistema comienza con la puerta cerrada
 }
 
+/*El cambio es un solo puntero: fsm() nunca ve una mezcla de tablas viejas y nuevas*/
+void FSM_SetTables(const fsm_tablas * tablas) {
+    activas = tablas != NULL ? tablas : &tablas_compiladas;
+}
+
+const fsm_tablas * FSM_GetTables(void) {
+    return activas;
+}
+
+uint8_t FSM_GetStateId(const STATE * estado) {
+    uint8_t id = 0;
+    while (id < activas->cantidad && activas->estados[id] != estado)
+        ++id;
+    return id; // La cantidad de estados si no es un estado conocido
+}
+
+const STATE * FSM_GetStateById(uint8_t id) {
+    return id < activas->cantidad ? activas->estados[id] : NULL;
+}
+
+void FSM_GetPending(fsm_pendientes * pendientes) {
+    pendientes->tarjetavalida = (int8_t)tarjetavalida;
+    pendientes->NumeroPulsado = NumeroPulsado;
+    pendientes->pinValido = (int8_t)pinValido;
+    pendientes->timeout_activo = timeout_activo;
+}
+
+void FSM_RestorePending(const fsm_pendientes * pendientes) {
+    tarjetavalida = pendientes->tarjetavalida;
+    NumeroPulsado = pendientes->NumeroPulsado;
+    pinValido = pendientes->pinValido;
+    timeout_activo = pendientes->timeout_activo;
+    if (timeout_activo) {
+        TIMER_Start(TIMER_TIMEOUT); // El timer no sobrevive al reset, se vuelve a iniciar completo
+    }
+}
+
+#ifdef FSM_SWITCH_DISPATCH
+/*Despacho generado desde FSM_Table.h: un switch por estado y otro por evento, con las rutinas de
+ * accion llamadas en forma directa para que el compilador pueda expandirlas*/
+#define CASO_ESTADO(estado)                                                                        \
+    case ID_##estado:                                                                              \
+        switch (evento_actual) {
+#define CASO_ARCO(evento, proximo, accion)                                                         \
+    case evento:                                                                                   \
+        METRICS_Inc(METRIC_TRANSITION(origen));                                                    \
+        accion();                                                                                  \
+        return ID_##proximo;
+#define CASO_FIN(estado, accion)                                                                   \
+    default:                                                                                       \
+        accion();                                                                                  \
+        return ID_##estado;                                                                        \
+        }
+
+/*Devuelve el id del proximo estado, no su puntero: asi fsm() sabe el origen de la siguiente
+ * llamada sin buscarlo en la tabla de estados*/
+static inline uint8_t despachar(uint8_t origen, eventos evento_actual) {
+    switch (origen) {
+        FSM_TABLA(CASO_ESTADO, CASO_ARCO, CASO_FIN)
+    default:
+        return origen; // No llega: origen ya se verifico contra las tablas compiladas
+    }
+}
+
+/*Ultimo estado que devolvio el switch y su id. El lazo principal le vuelve a pasar a fsm() ese
+ * mismo puntero, solo otro estado (una sesion restaurada, un test) obliga a buscar el id*/
+static const STATE * ultimo_estado = NULL;
+static uint8_t ultimo_id = 0;
+#endif
+
 /*Interprete de la maquina de estados*/
-STATE * fsm(STATE * p_tabla_estado,
-            eventos evento_actual) { // Puntero al estado actual , Evento recibido
+const STATE * fsm(const STATE * p_tabla_estado,
+                  eventos evento_actual) { // Puntero al estado actual , Evento recibido
+    if (evento_actual < FIN_TABLA) {
+        METRICS_Inc(METRIC_EVENT(evento_actual));
+    }
+
+#ifdef FSM_SWITCH_DISPATCH
+    // Una imagen cargada con FSM_IMAGE no tiene switch generado y se sigue recorriendo
+    if (activas == &tablas_compiladas) {
+        uint8_t id = p_tabla_estado == ultimo_estado ? ultimo_id : FSM_GetStateId(p_tabla_estado);
+        if (id < FSM_CANTIDAD_ESTADOS) {
+            ultimo_id = despachar(id, evento_actual);
+            ultimo_estado = estados[ultimo_id];
+            return ultimo_estado;
+        }
+    }
+#endif
+
+    uint8_t origen = FSM_GetStateId(p_tabla_estado);
+
     // 1-Recorremos las tabla de estado ( Ej estado_0) hasta encontrar el arco que contenga el
     // evento actual
     while (p_tabla_estado->evento != evento_actual && p_tabla_estado->evento != FIN_TABLA)
         ++p_tabla_estado;
 
+    // Los eventos que el estado no atiende caen en FIN_TABLA y no cuentan como transicion
+    if (p_tabla_estado->evento != FIN_TABLA && origen < activas->cantidad) {
+        METRICS_Inc(METRIC_TRANSITION(origen));
+    }
+
     (*p_tabla_estado->p_rutina_accion)(); /*2- Ejecuta Rutina de accion corresondiente*/
 
     p_tabla_estado = p_tabla_estado->proximo_estado; /*3-Encuentro próximo estado*/
@@ -73,10 +189,18 @@ eventos get_event(void) {
         pinValido = 0;
         return PIN_INVALIDO;
     }
+    if (sesion_bloqueada) {
+        sesion_bloqueada = false;
+        return TIMEOUT_DEFAULT; // Corta la sesion igual que un timeout, en cualquier estado
+    }
 
+    /*Un vencimiento sin timeout_activo es de una sesion que ya termino: no corta la actual*/
     if (TIME_GetTimeStatus(TIMER_TIMEOUT)) {
         TIME_ResetTimeStatus(TIMER_TIMEOUT);
-        return TIMEOUT_DEFAULT;
+        if (timeout_activo) {
+            timeout_activo = false;
+            return TIMEOUT_DEFAULT;
+        }
     }
     return FIN_TABLA;
 }
@@ -87,43 +211,75 @@ eventos get_event(void) {
 void no_operation(void) {
 }
 
-void validar_id_tarjeta(void) {
-    // TIMER_Start(TIMER_TIMEOUT);
-    if (USERS_DATA_VALIDATE_KEYCARD(GetKeyRead())) {
+/*Si la tarjeta quedo consultandose en el servidor se espera la respuesta sin bloquear el lazo. El
+ * timeout queda corriendo mientras tanto, asi un servidor caido no deja la puerta trabada*/
+static task_result validacion_tarjeta(task_ctx * ctx) {
+    static bool existe;
+
+    TASK_BEGIN(ctx);
+    existe = USERS_DATA_VALIDATE_KEYCARD(tarjeta_actual);
+    if (USERS_DATA_KEYCARD_PENDING()) {
+        TIMER_Start(TIMER_TIMEOUT);
+        timeout_activo = true;
+        TASK_WAIT_UNTIL(ctx, !USERS_DATA_KEYCARD_PENDING());
+        existe = USERS_DATA_VALIDATE_KEYCARD(tarjeta_actual);
+    }
+
+    // La tarjeta tiene que existir y ademas estar dentro de su horario para esta puerta
+    if (existe && ACCESS_RULES_Check(USERS_DATA_GET_CURRENT_USER_ID())) {
         tarjetavalida = 1;
         NumeroPulsado = 0; // permito eventos de teclado
     } else {
         tarjetavalida = -1;
     }
+    TASK_END(ctx);
+}
+
+void validar_id_tarjeta(void) {
+    // TIMER_Start(TIMER_TIMEOUT);
+    memcpy(tarjeta_actual, GetKeyRead(), sizeof(KeyCard));
+    // Con la tarjeta o la puerta bloqueada no se consulta al servidor ni se habilita el teclado
+    if (!LOCKOUT_Allowed(tarjeta_actual) || !TASKS_Start(validacion_tarjeta)) {
+        tarjetavalida = -1;
+    }
 }
 
 void lectura_primer_numero(void) {
     TIMER_Start(TIMER_TIMEOUT);
+    timeout_activo = true;
     USERS_DATA_COLLECT_FIRST_NUMBER(&NumeroPulsado);
     NumeroPulsado = 0;
     LED_KeyboardPress();
 }
 void lectura_segundo_numero(void) {
     TIMER_Start(TIMER_TIMEOUT);
+    timeout_activo = true;
     USERS_DATA_COLLECT_SECOND_NUMBER(&NumeroPulsado);
     NumeroPulsado = 0;
     LED_KeyboardPress();
 }
 void lectura_tercer_numero(void) {
     TIMER_Start(TIMER_TIMEOUT);
+    timeout_activo = true;
     USERS_DATA_COLLECT_THIRD_NUMBER(&NumeroPulsado);
     NumeroPulsado = 0;
     LED_KeyboardPress();
 }
 void lectura_cuarto_numero(void) {
     TIMER_Start(TIMER_TIMEOUT);
+    timeout_activo = true;
     USERS_DATA_COLLECT_FOURTH_NUMBER(&NumeroPulsado);
     NumeroPulsado = 0;
     LED_KeyboardPress();
     if (USERS_DATA_VALIDATE_PIN()) {
         pinValido = 1;
+        LOCKOUT_RecordSuccess(tarjeta_actual);
     } else {
         pinValido = -1;
+        if (LOCKOUT_RecordFailure(tarjeta_actual)) {
+            sesion_bloqueada = true;
+            NumeroPulsado = -1; // No se vuelve a leer el teclado en esta sesion
+        }
     }
 }
 
@@ -136,9 +292,13 @@ void cerrar_puerta(void) {
     LED_OPEN_DOOR();
 }
 void reset_FSM(void) {
+    TASKS_Cancel(validacion_tarjeta); // Una respuesta tardia del servidor ya no tiene efecto
     tarjetavalida = 0;
     NumeroPulsado = -1;
     pinValido = 0;
+    timeout_activo = false;
+    TIME_ResetTimeStatus(TIMER_TIMEOUT); // La sesion pudo terminar antes de que venza
+    sesion_bloqueada = false;
 }
 
 void test_set_NumeroPulsado(char value) {
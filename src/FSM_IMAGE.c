@@ -0,0 +1,257 @@
+/*
+ * FSM_IMAGE.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "FSM_IMAGE.h"
+#include <stddef.h>
+#include <string.h>
+#include "BYTES.h"
+
+/*Una imagen enlazada: los arcos con punteros resueltos, listos para que fsm() los recorra igual
+ * que a las tablas compiladas*/
+typedef struct {
+    STATE arcos[FSM_IMAGE_MAX_EDGES];
+    const STATE * estados[FSM_MAX_ESTADOS];
+    fsm_tablas tablas;
+} banco;
+
+/*Uno de los bancos puede estar en uso por la FSM; la imagen nueva se enlaza siempre en el otro*/
+static banco bancos[2];
+static bool hay_pendiente = false;
+static const fsm_tablas * pendiente = NULL; // NULL son las tablas compiladas
+
+static void (*const acciones[FSM_ACCIONES])(void) = {
+    [FSM_ACCION_NO_OPERATION] = no_operation,
+    [FSM_ACCION_VALIDAR_ID_TARJETA] = validar_id_tarjeta,
+    [FSM_ACCION_LECTURA_PRIMER_NUMERO] = lectura_primer_numero,
+    [FSM_ACCION_LECTURA_SEGUNDO_NUMERO] = lectura_segundo_numero,
+    [FSM_ACCION_LECTURA_TERCER_NUMERO] = lectura_tercer_numero,
+    [FSM_ACCION_LECTURA_CUARTO_NUMERO] = lectura_cuarto_numero,
+    [FSM_ACCION_ABRIR_PUERTA] = abrir_puerta,
+    [FSM_ACCION_CERRAR_PUERTA] = cerrar_puerta,
+    [FSM_ACCION_RESET_FSM] = reset_FSM};
+
+/*Sobre una imagen bien formada: abrir_puerta solo con PIN_VALIDO y hacia estados distintos del
+ * inicial, y desde esos estados solo se sale por cerrar_puerta. Cada uno tiene que tener al
+ * menos una salida, si no la puerta quedaria abierta para siempre*/
+static bool puerta_segura(const uint8_t * arcos, uint16_t cantidad) {
+    uint16_t abiertos = 0; // Estados en los que la puerta queda abierta
+    uint16_t cerrados = 0; // Estados con al menos un arco que cierra la puerta y sale
+    const uint8_t * arco = arcos;
+    for (uint16_t i = 0; i < cantidad; i++, arco += FSM_IMAGE_EDGE_LEN) {
+        if (arco[2] == FSM_ACCION_ABRIR_PUERTA) {
+            if (arco[0] != PIN_VALIDO) {
+                return false;
+            }
+            abiertos |= (uint16_t)(1U << arco[1]);
+        }
+    }
+    if ((abiertos & 1U) != 0) {
+        return false;
+    }
+
+    uint8_t estado = 0;
+    arco = arcos;
+    for (uint16_t i = 0; i < cantidad; i++, arco += FSM_IMAGE_EDGE_LEN) {
+        if ((abiertos & (1U << estado)) != 0 && arco[1] != estado) {
+            if (arco[2] != FSM_ACCION_CERRAR_PUERTA) {
+                return false;
+            }
+            cerrados |= (uint16_t)(1U << estado);
+        }
+        if (arco[0] == FIN_TABLA) {
+            estado++;
+        }
+    }
+    return (abiertos & cerrados) == abiertos;
+}
+
+/**
+ * @brief Verifica una imagen de tablas sin activarla
+ *
+ * Ademas del CRC se recorren todos los arcos, asi una imagen aceptada no puede llevar a fsm() a
+ * un estado, evento o rutina de accion que no existe, ni abrir la puerta fuera del camino del PIN.
+ *
+ * @return fsm_image_status FSM_IMAGE_OK si se puede cargar
+ */
+fsm_image_status FSM_IMAGE_Validate(const uint8_t * imagen, uint16_t largo) {
+    if (imagen == NULL || largo < FSM_IMAGE_LEN(0)) {
+        return FSM_IMAGE_ERR_LARGO;
+    }
+    uint8_t estados = imagen[5];
+    uint16_t arcos = BYTES_GetU16(&imagen[6]);
+    if (memcmp(imagen, FSM_IMAGE_MAGIC, 4) != 0 || imagen[4] != FSM_IMAGE_FORMAT ||
+        estados == 0 || estados > FSM_MAX_ESTADOS || arcos > FSM_IMAGE_MAX_EDGES) {
+        return FSM_IMAGE_ERR_FORMATO;
+    }
+    if (largo != FSM_IMAGE_LEN(arcos)) {
+        return FSM_IMAGE_ERR_LARGO;
+    }
+    if (BYTES_Crc32(imagen, largo - 4U) != BYTES_GetU32(&imagen[largo - 4U])) {
+        return FSM_IMAGE_ERR_CRC;
+    }
+
+    const uint8_t * arco = &imagen[FSM_IMAGE_HEADER_LEN];
+    uint8_t estado = 0;
+    uint16_t vistos = 0; // Eventos que ya tienen arco en el estado que se esta recorriendo
+    for (uint16_t i = 0; i < arcos; i++, arco += FSM_IMAGE_EDGE_LEN) {
+        if (estado == estados) {
+            return FSM_IMAGE_ERR_TABLA; // Arcos despues del ultimo estado
+        }
+        if (arco[0] > FIN_TABLA || (vistos & (1U << arco[0])) != 0) {
+            return FSM_IMAGE_ERR_EVENTO;
+        }
+        if (arco[1] >= estados) {
+            return FSM_IMAGE_ERR_ESTADO;
+        }
+        if (arco[2] >= FSM_ACCIONES) {
+            return FSM_IMAGE_ERR_ACCION;
+        }
+        vistos |= (uint16_t)(1U << arco[0]);
+        if (arco[0] == FIN_TABLA) {
+            if (arco[1] != estado) {
+                return FSM_IMAGE_ERR_TABLA; // Un evento sin arco no puede cambiar de estado
+            }
+            estado++;
+            vistos = 0;
+        }
+    }
+    if (estado != estados) {
+        return FSM_IMAGE_ERR_TABLA;
+    }
+    if (!puerta_segura(&imagen[FSM_IMAGE_HEADER_LEN], arcos)) {
+        return FSM_IMAGE_ERR_PUERTA;
+    }
+    return FSM_IMAGE_OK;
+}
+
+/*La imagen ya fue validada. Primero se ubica el comienzo de cada estado y despues se resuelven
+ * los proximos estados, que pueden apuntar hacia adelante*/
+static void enlazar(banco * destino, const uint8_t * imagen) {
+    uint8_t estados = imagen[5];
+    uint16_t arcos = BYTES_GetU16(&imagen[6]);
+    const uint8_t * arco = &imagen[FSM_IMAGE_HEADER_LEN];
+    uint8_t estado = 0;
+
+    destino->estados[0] = destino->arcos;
+    for (uint16_t i = 0; i < arcos; i++, arco += FSM_IMAGE_EDGE_LEN) {
+        destino->arcos[i].evento = (eventos)arco[0];
+        destino->arcos[i].p_rutina_accion = acciones[arco[2]];
+        if (arco[0] == FIN_TABLA && ++estado < estados) {
+            destino->estados[estado] = &destino->arcos[i + 1];
+        }
+    }
+    arco = &imagen[FSM_IMAGE_HEADER_LEN];
+    for (uint16_t i = 0; i < arcos; i++, arco += FSM_IMAGE_EDGE_LEN) {
+        destino->arcos[i].proximo_estado = destino->estados[arco[1]];
+    }
+    destino->tablas.estados = destino->estados;
+    destino->tablas.cantidad = estados;
+    destino->tablas.version = BYTES_GetU16(&imagen[8]);
+}
+
+/**
+ * @brief Valida una imagen y la deja lista para activarse en el proximo punto seguro
+ *
+ * La imagen se copia, no hace falta conservarla despues. Una carga reemplaza a otra que todavia
+ * no se haya activado.
+ *
+ * @return fsm_image_status FSM_IMAGE_OK si quedo pendiente de activar
+ */
+fsm_image_status FSM_IMAGE_Load(const uint8_t * imagen, uint16_t largo) {
+    fsm_image_status estado = FSM_IMAGE_Validate(imagen, largo);
+    if (estado != FSM_IMAGE_OK) {
+        return estado;
+    }
+
+    banco * libre = FSM_GetTables() == &bancos[0].tablas ? &bancos[1] : &bancos[0];
+    hay_pendiente = false;
+    enlazar(libre, imagen);
+    pendiente = &libre->tablas;
+    hay_pendiente = true;
+    return FSM_IMAGE_OK;
+}
+
+/*Vuelve a las tablas compiladas en el proximo punto seguro*/
+void FSM_IMAGE_LoadBuiltin(void) {
+    pendiente = NULL;
+    hay_pendiente = true;
+}
+
+static uint16_t contar_arcos(const fsm_tablas * tablas) {
+    uint16_t arcos = 0;
+    for (uint8_t id = 0; id < tablas->cantidad; id++) {
+        const STATE * arco = tablas->estados[id];
+        while (arco->evento != FIN_TABLA) {
+            arco++;
+        }
+        arcos += (uint16_t)(arco - tablas->estados[id] + 1);
+    }
+    return arcos;
+}
+
+static uint8_t numero_de_accion(void (*rutina)(void)) {
+    uint8_t accion = 0;
+    while (accion < FSM_ACCIONES && acciones[accion] != rutina) {
+        accion++;
+    }
+    return accion;
+}
+
+/**
+ * @brief Serializa las tablas activas, para editarlas fuera del equipo y volver a cargarlas
+ *
+ * @return uint16_t Largo de la imagen, 0 si no entra en el buffer
+ */
+uint16_t FSM_IMAGE_Export(uint8_t * imagen, uint16_t largo) {
+    const fsm_tablas * tablas = FSM_GetTables();
+    uint16_t arcos = contar_arcos(tablas);
+    if (arcos > FSM_IMAGE_MAX_EDGES || largo < FSM_IMAGE_LEN(arcos)) {
+        return 0;
+    }
+
+    uint8_t * p = imagen;
+    memcpy(p, FSM_IMAGE_MAGIC, 4);
+    p[4] = FSM_IMAGE_FORMAT;
+    p[5] = tablas->cantidad;
+    p = BYTES_PutU16(&p[6], arcos);
+    p = BYTES_PutU16(p, tablas->version);
+    p = BYTES_PutU16(p, 0);
+    for (uint8_t id = 0; id < tablas->cantidad; id++) {
+        const STATE * arco = tablas->estados[id];
+        do {
+            p[0] = (uint8_t)arco->evento;
+            p[1] = FSM_GetStateId(arco->proximo_estado);
+            p[2] = numero_de_accion(arco->p_rutina_accion);
+            p += FSM_IMAGE_EDGE_LEN;
+        } while ((arco++)->evento != FIN_TABLA);
+    }
+    p = BYTES_PutU32(p, BYTES_Crc32(imagen, (size_t)(p - imagen)));
+    return (uint16_t)(p - imagen);
+}
+
+bool FSM_IMAGE_Pending(void) {
+    return hay_pendiente;
+}
+
+/**
+ * @brief Activa las tablas pendientes si la maquina esta en reposo
+ *
+ * Se llama desde el lazo principal entre dos llamadas a fsm(), cuando no hay eventos ni tareas
+ * pendientes. Fuera del estado inicial no se cambia nada: una sesion a medio hacer termina con
+ * las tablas con las que empezo.
+ *
+ * @param estado Estado actual de la maquina
+ * @return const STATE* Estado desde el que seguir: el inicial de las tablas nuevas si hubo cambio
+ */
+const STATE * FSM_IMAGE_Apply(const STATE * estado) {
+    if (!hay_pendiente || estado != FSM_GetInitState()) {
+        return estado;
+    }
+    FSM_SetTables(pendiente);
+    hay_pendiente = false;
+    return FSM_GetInitState();
+}
@@ -0,0 +1,137 @@
+/*
+ * FSM_RETAIN.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "FSM_RETAIN.h"
+#include <stddef.h>
+#include <string.h>
+#include "BYTES.h"
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint8_t estado;
+    uint8_t perifericos_listos; // Los perifericos externos (RC522) quedaron configurados
+    fsm_pendientes pendientes;
+    uint32_t crc; // Siempre el ultimo campo
+} fsm_sesion_retenida;
+
+typedef struct {
+    uint32_t magic;
+    fsm_retain_stats stats;
+    uint32_t crc; // Siempre el ultimo campo
+} fsm_contadores_retenidos;
+
+typedef struct {
+    fsm_sesion_retenida sesion;
+    fsm_contadores_retenidos contadores; // Fuera de la sesion: sobreviven al arranque en frio
+} fsm_retenido;
+
+#ifdef __linux__
+#define FSM_RETAIN_SECTION
+#else
+#define FSM_RETAIN_SECTION __attribute__((section(".noinit")))
+#endif
+
+static fsm_retenido area_retenida FSM_RETAIN_SECTION;
+static fsm_sesion_retenida * retenido = &area_retenida.sesion;
+static fsm_contadores_retenidos * contadores = &area_retenida.contadores;
+
+static uint32_t calcular_crc(void) {
+    return BYTES_Crc32((const uint8_t *)retenido, offsetof(fsm_sesion_retenida, crc));
+}
+
+static uint32_t calcular_crc_contadores(void) {
+    return BYTES_Crc32((const uint8_t *)contadores, offsetof(fsm_contadores_retenidos, crc));
+}
+
+static bool es_valido(void) {
+    return retenido->magic == FSM_RETAIN_MAGIC && retenido->version == FSM_RETAIN_VERSION &&
+           retenido->estado < FSM_CANTIDAD_ESTADOS && retenido->crc == calcular_crc();
+}
+
+static void sellar(void) {
+    retenido->crc = calcular_crc();
+}
+
+/**
+ * @brief Valida la RAM retenida despues de un reset
+ *
+ * @param almacenamiento NULL para usar la seccion .noinit, o una memoria que sobreviva al proceso
+ * cuando se simula en Linux
+ * @param causa Causa del reset, decide si la sesion guardada se puede retomar
+ */
+void FSM_RETAIN_Init(void * almacenamiento, fsm_reset_cause causa) {
+    fsm_retenido * area = almacenamiento != NULL ? (fsm_retenido *)almacenamiento : &area_retenida;
+    retenido = &area->sesion;
+    contadores = &area->contadores;
+
+    bool reanudable = causa == FSM_RESET_WATCHDOG || causa == FSM_RESET_SOFTWARE;
+    if (!reanudable || !es_valido()) {
+        memset(retenido, 0, sizeof(*retenido));
+    }
+    if (contadores->magic != FSM_RETAIN_STATS_MAGIC ||
+        contadores->crc != calcular_crc_contadores()) {
+        memset(contadores, 0, sizeof(*contadores)); // Contenido aleatorio del primer encendido
+    }
+}
+
+bool FSM_RETAIN_Restore(uint8_t * estado, fsm_pendientes * pendientes) {
+    if (!es_valido()) {
+        return false;
+    }
+    *estado = retenido->estado;
+    *pendientes = retenido->pendientes;
+    return true;
+}
+
+void FSM_RETAIN_Save(uint8_t estado, const fsm_pendientes * pendientes) {
+    if (estado >= FSM_CANTIDAD_ESTADOS) {
+        return;
+    }
+    retenido->magic = FSM_RETAIN_MAGIC;
+    retenido->version = FSM_RETAIN_VERSION;
+    retenido->estado = estado;
+    memset(&retenido->pendientes, 0, sizeof(retenido->pendientes)); // Relleno determinista
+    retenido->pendientes.tarjetavalida = pendientes->tarjetavalida;
+    retenido->pendientes.NumeroPulsado = pendientes->NumeroPulsado;
+    retenido->pendientes.pinValido = pendientes->pinValido;
+    retenido->pendientes.timeout_activo = pendientes->timeout_activo;
+    sellar();
+}
+
+void FSM_RETAIN_Invalidate(void) {
+    retenido->magic = 0;
+    retenido->crc = ~calcular_crc();
+}
+
+void FSM_RETAIN_SetPeripheralsReady(bool listos) {
+    retenido->perifericos_listos = listos;
+    if (retenido->magic == FSM_RETAIN_MAGIC) {
+        sellar();
+    }
+}
+
+bool FSM_RETAIN_GetPeripheralsReady(void) {
+    return es_valido() && retenido->perifericos_listos;
+}
+
+void FSM_RETAIN_RecordBoot(bool caliente, uint32_t arranque_us) {
+    fsm_retain_stats * stats = &contadores->stats;
+    if (caliente) {
+        stats->arranques_calientes++;
+        stats->ultimo_caliente_us = arranque_us;
+    } else {
+        stats->arranques_frios++;
+        stats->ultimo_frio_us = arranque_us;
+    }
+    contadores->magic = FSM_RETAIN_STATS_MAGIC;
+    contadores->crc = calcular_crc_contadores();
+}
+
+const fsm_retain_stats * FSM_RETAIN_GetStats(void) {
+    return &contadores->stats;
+}
@@ -0,0 +1,135 @@
+/*
+ * IDLE.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE // ppoll
+#endif
+#include "IDLE.h"
+#include <stddef.h>
+#include <string.h>
+
+static uint32_t (*reloj)(void);
+static bool (*trabajo_pendiente)(void);
+
+static idle_stats estadisticas;
+static uint32_t inicio_ventana;
+static uint32_t dormido_ventana;
+static uint32_t despertares_ventana;
+
+/*Comparacion que sigue funcionando cuando el contador de microsegundos da la vuelta*/
+static bool antes(uint32_t a, uint32_t b) {
+    return (int32_t)(a - b) < 0;
+}
+
+#ifdef __linux__
+#include <poll.h>
+#include <time.h>
+
+static struct pollfd vigilados[IDLE_MAX_FDS];
+static int cantidad_vigilados;
+
+static void preparar_plataforma(void) {
+    memset(vigilados, 0, sizeof(vigilados));
+    cantidad_vigilados = 0;
+}
+
+void IDLE_WatchFd(int fd) {
+    if (fd < 0 || cantidad_vigilados == IDLE_MAX_FDS) {
+        return;
+    }
+    vigilados[cantidad_vigilados].fd = fd;
+    vigilados[cantidad_vigilados].events = POLLIN;
+    cantidad_vigilados++;
+}
+
+/*Vuelve al vencer el plazo o cuando cualquiera de los descriptores tiene datos. Las banderas
+ * de hay_trabajo no despiertan a ppoll, las cubre IDLE_MAX_SLEEP_US*/
+static void esperar(uint32_t limite) {
+    uint32_t ahora = reloj();
+    if (!antes(ahora, limite)) {
+        return;
+    }
+    uint32_t restante = limite - ahora;
+    struct timespec ts = {.tv_sec = restante / 1000000U, .tv_nsec = (restante % 1000000U) * 1000};
+
+    ppoll(vigilados, (nfds_t)cantidad_vigilados, &ts, NULL);
+}
+#else
+#include "stm32f4xx.h" // __WFI
+
+static void preparar_plataforma(void) {
+}
+
+/*El SysTick sigue corriendo para no perder la base de tiempo de la HAL: cada milisegundo el
+ * nucleo despierta, ve que no hay nada que hacer y vuelve a dormir sin pasar por el lazo
+ * principal. El TIM10 del timeout y cualquier otra interrupcion tambien lo despiertan*/
+static void esperar(uint32_t limite) {
+    while (!(trabajo_pendiente != NULL && trabajo_pendiente()) && antes(reloj(), limite)) {
+        __WFI();
+    }
+}
+#endif
+
+static void cerrar_ventana(uint32_t ahora) {
+    uint32_t total = ahora - inicio_ventana;
+    uint32_t despierto = total - dormido_ventana;
+
+    estadisticas.ciclo_util_permil = (uint16_t)((uint64_t)despierto * 1000U / total);
+    estadisticas.despertares_por_seg =
+        (uint16_t)((uint64_t)despertares_ventana * 1000000U / total);
+    estadisticas.ventanas++;
+    inicio_ventana = ahora;
+    dormido_ventana = 0;
+    despertares_ventana = 0;
+}
+
+/**
+ * @brief Prepara el reposo sin tick
+ *
+ * @param reloj_us Base de tiempo en microsegundos
+ * @param hay_trabajo Consulta a los servicios que avisan por bandera (el timer del timeout), se
+ * revisa antes de dormir y en cada despertar. Puede ser NULL
+ */
+void IDLE_Init(uint32_t (*reloj_us)(void), bool (*hay_trabajo)(void)) {
+    reloj = reloj_us;
+    trabajo_pendiente = hay_trabajo;
+    memset(&estadisticas, 0, sizeof(estadisticas));
+    inicio_ventana = reloj();
+    dormido_ventana = 0;
+    despertares_ventana = 0;
+    preparar_plataforma();
+}
+
+/**
+ * @brief Duerme hasta la proxima encuesta o hasta que llegue un evento
+ *
+ * Se llama cuando get_event() no tiene nada para entregar.
+ *
+ * @return true si llego a dormir, false si habia trabajo pendiente
+ */
+bool IDLE_Sleep(void) {
+    uint32_t inicio = reloj();
+
+    if (trabajo_pendiente != NULL && trabajo_pendiente()) {
+        return false;
+    }
+
+    esperar(inicio + IDLE_MAX_SLEEP_US);
+
+    uint32_t fin = reloj();
+    dormido_ventana += fin - inicio;
+    despertares_ventana++;
+    estadisticas.despertares++;
+    if (fin - inicio_ventana >= IDLE_STATS_WINDOW_US) {
+        cerrar_ventana(fin);
+    }
+    return true;
+}
+
+const idle_stats * IDLE_GetStats(void) {
+    return &estadisticas;
+}
@@ -0,0 +1,229 @@
+/*
+ * LOCKOUT.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "LOCKOUT.h"
+#include <stddef.h>
+#include <string.h>
+#include "METRICS.h"
+
+#define NINGUNA     0xFF
+#define CUBETA_BITS 6 // Tabla de dispersion con el doble de cubetas que tarjetas
+#define CUBETAS     (1U << CUBETA_BITS)
+
+_Static_assert(LOCKOUT_MAX_CARDS < NINGUNA && CUBETAS >= LOCKOUT_MAX_CARDS,
+               "LOCKOUT_MAX_CARDS fuera de rango");
+
+typedef struct {
+    uint8_t fallos;        // Fallos seguidos, sin un PIN correcto en el medio
+    uint32_t ultimo_fallo;
+    uint32_t hasta;        // Fin del bloqueo, igual a ultimo_fallo si no bloqueo
+} contador;
+
+/*Las tarjetas se encadenan dos veces con indices de un byte: por cubeta para encontrarlas en
+ * O(1) y en orden de uso para desalojar la menos reciente sin recorrer la tabla*/
+typedef struct {
+    uint32_t clave;
+    contador fallos;
+    uint8_t siguiente_cubeta;
+    uint8_t anterior;  // Mas reciente
+    uint8_t siguiente; // Menos reciente
+} tarjeta;
+
+static tarjeta tarjetas[LOCKOUT_MAX_CARDS];
+static uint8_t cubetas[CUBETAS];
+static uint8_t usadas;
+static uint8_t mas_reciente;
+static uint8_t menos_reciente;
+static contador puerta;
+static lockout_stats estadisticas;
+static uint32_t (*reloj)(void);
+
+static uint32_t clave_de(const uint8_t * uid) {
+    return (uint32_t)uid[0] | (uint32_t)uid[1] << 8 | (uint32_t)uid[2] << 16 |
+           (uint32_t)uid[3] << 24;
+}
+
+/*Dispersion multiplicativa: los UID de un mismo lote suelen diferir en pocos bits*/
+static uint8_t cubeta_de(uint32_t clave) {
+    return (uint8_t)((clave * 2654435761U) >> (32 - CUBETA_BITS));
+}
+
+static uint8_t buscar(uint32_t clave) {
+    uint8_t i = cubetas[cubeta_de(clave)];
+    while (i != NINGUNA && tarjetas[i].clave != clave) {
+        i = tarjetas[i].siguiente_cubeta;
+    }
+    return i;
+}
+
+static void quitar_de_la_cubeta(uint8_t i) {
+    uint8_t * enlace = &cubetas[cubeta_de(tarjetas[i].clave)];
+    while (*enlace != i) {
+        enlace = &tarjetas[*enlace].siguiente_cubeta;
+    }
+    *enlace = tarjetas[i].siguiente_cubeta;
+}
+
+static void quitar_del_orden(uint8_t i) {
+    if (tarjetas[i].anterior != NINGUNA) {
+        tarjetas[tarjetas[i].anterior].siguiente = tarjetas[i].siguiente;
+    } else {
+        mas_reciente = tarjetas[i].siguiente;
+    }
+    if (tarjetas[i].siguiente != NINGUNA) {
+        tarjetas[tarjetas[i].siguiente].anterior = tarjetas[i].anterior;
+    } else {
+        menos_reciente = tarjetas[i].anterior;
+    }
+}
+
+static void poner_primera(uint8_t i) {
+    tarjetas[i].anterior = NINGUNA;
+    tarjetas[i].siguiente = mas_reciente;
+    if (mas_reciente != NINGUNA) {
+        tarjetas[mas_reciente].anterior = i;
+    } else {
+        menos_reciente = i;
+    }
+    mas_reciente = i;
+}
+
+/*Mientras quede lugar se usa una entrada nueva, despues se reemplaza la menos reciente*/
+static uint8_t agregar(uint32_t clave) {
+    uint8_t i;
+    if (usadas < LOCKOUT_MAX_CARDS) {
+        i = usadas++;
+    } else {
+        i = menos_reciente;
+        quitar_de_la_cubeta(i);
+        quitar_del_orden(i);
+        estadisticas.desalojos++;
+    }
+
+    uint8_t cubeta = cubeta_de(clave);
+    memset(&tarjetas[i], 0, sizeof(tarjetas[i]));
+    tarjetas[i].clave = clave;
+    tarjetas[i].siguiente_cubeta = cubetas[cubeta];
+    cubetas[cubeta] = i;
+    poner_primera(i);
+    return i;
+}
+
+/*Pasado LOCKOUT_FORGET_MS del ultimo fallo el contador ya no cuenta. Dentro de esa ventana la
+ * resta de tiempos con signo no tiene problemas con la vuelta del reloj*/
+static bool vigente(const contador * c, uint32_t ahora) {
+    return c->fallos != 0 && ahora - c->ultimo_fallo < LOCKOUT_FORGET_MS;
+}
+
+static uint32_t restante(const contador * c, uint32_t ahora) {
+    if (!vigente(c, ahora) || (int32_t)(c->hasta - ahora) <= 0) {
+        return 0;
+    }
+    return c->hasta - ahora;
+}
+
+/*Devuelve true si el fallo dejo el contador bloqueado*/
+static bool registrar_fallo(contador * c, uint32_t ahora, uint8_t libres, uint32_t base) {
+    if (!vigente(c, ahora)) {
+        c->fallos = 0;
+    }
+    if (c->fallos < UINT8_MAX) {
+        c->fallos++;
+    }
+    c->ultimo_fallo = ahora;
+    c->hasta = ahora;
+    if (c->fallos <= libres) {
+        return false;
+    }
+
+    uint8_t duplicaciones = (uint8_t)(c->fallos - libres - 1);
+    uint32_t espera = LOCKOUT_MAX_MS;
+    if (duplicaciones < 16 && (base << duplicaciones) < LOCKOUT_MAX_MS) {
+        espera = base << duplicaciones;
+    }
+    c->hasta = ahora + espera;
+    return true;
+}
+
+void LOCKOUT_Init(uint32_t (*reloj_ms)(void)) {
+    reloj = reloj_ms;
+    usadas = 0;
+    mas_reciente = NINGUNA;
+    menos_reciente = NINGUNA;
+    memset(cubetas, NINGUNA, sizeof(cubetas));
+    memset(&puerta, 0, sizeof(puerta));
+    memset(&estadisticas, 0, sizeof(estadisticas));
+}
+
+/**
+ * @brief Indica si la tarjeta puede pasar a ingresar el PIN
+ *
+ * Se consulta antes de validar la tarjeta, asi una tarjeta o una puerta bloqueada no llega a
+ * ocupar al servidor, a la FSM ni al teclado. Una busqueda en la tabla de dispersion, sin
+ * modificar el orden de uso.
+ *
+ * @param uid UID de la tarjeta, los 4 bytes de KeyCard
+ * @return true si no hay un bloqueo vigente para la tarjeta ni para la puerta
+ */
+bool LOCKOUT_Allowed(const uint8_t * uid) {
+    if (LOCKOUT_RemainingMs(uid) == 0) {
+        return true;
+    }
+    estadisticas.rechazos++;
+    METRICS_Inc(METRIC_LOCKOUT_REJECTS);
+    return false;
+}
+
+/**
+ * @brief Registra un PIN incorrecto para la tarjeta y para la puerta
+ *
+ * @return true si la tarjeta o la puerta quedaron bloqueadas: la sesion tiene que terminar
+ */
+bool LOCKOUT_RecordFailure(const uint8_t * uid) {
+    uint32_t ahora = reloj();
+    uint32_t clave = clave_de(uid);
+    uint8_t i = buscar(clave);
+
+    if (i == NINGUNA) {
+        i = agregar(clave);
+    } else if (i != mas_reciente) {
+        quitar_del_orden(i);
+        poner_primera(i);
+    }
+
+    bool bloqueo = registrar_fallo(&tarjetas[i].fallos, ahora, LOCKOUT_FREE_FAILURES,
+                                   LOCKOUT_BASE_MS);
+    bloqueo |= registrar_fallo(&puerta, ahora, LOCKOUT_DOOR_FREE_FAILURES, LOCKOUT_DOOR_BASE_MS);
+    if (bloqueo) {
+        estadisticas.bloqueos++;
+    }
+    return bloqueo;
+}
+
+/*Un PIN correcto solo absuelve a su tarjeta. El contador de la puerta se olvida recien pasado
+ * LOCKOUT_FORGET_MS: si no, un atacante intercalaria su propia tarjeta para reiniciarlo*/
+void LOCKOUT_RecordSuccess(const uint8_t * uid) {
+    uint8_t i = buscar(clave_de(uid));
+    if (i != NINGUNA) {
+        tarjetas[i].fallos.fallos = 0;
+    }
+}
+
+uint32_t LOCKOUT_RemainingMs(const uint8_t * uid) {
+    uint32_t ahora = reloj();
+    uint32_t espera = restante(&puerta, ahora);
+    uint8_t i = buscar(clave_de(uid));
+
+    if (i != NINGUNA && restante(&tarjetas[i].fallos, ahora) > espera) {
+        espera = restante(&tarjetas[i].fallos, ahora);
+    }
+    return espera;
+}
+
+const lockout_stats * LOCKOUT_GetStats(void) {
+    return &estadisticas;
+}
@@ -0,0 +1,109 @@
+/*
+ * METRICS.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "METRICS.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+#include "BYTES.h"
+
+/*Un incremento relajado por muestra (LDREX/STREX en el Cortex-M4), sin bloqueos ni deshabilitar
+ * interrupciones. La trama lee cada contador por separado: no es una foto atomica del conjunto,
+ * pero al ser monotonos el colector no ve valores que retrocedan*/
+static atomic_uint_least32_t contadores[METRICS_COUNTERS];
+static atomic_uint_least32_t cubetas[METRICS_HISTOGRAMS][METRICS_BUCKETS];
+
+static const metrics_sink * salida = NULL;
+static uint32_t secuencia;
+static uint32_t ultimo_envio;
+
+static uint8_t cubeta(uint32_t valor) {
+    if (valor == 0) {
+        return 0;
+    }
+    uint8_t bits = (uint8_t)(32 - __builtin_clz(valor));
+    return bits < METRICS_BUCKETS ? bits : METRICS_BUCKETS - 1;
+}
+
+void METRICS_Init(const metrics_sink * sink) {
+    salida = sink;
+    secuencia = 0;
+    ultimo_envio = 0;
+    for (uint8_t i = 0; i < METRICS_COUNTERS; i++) {
+        atomic_init(&contadores[i], 0);
+    }
+    for (uint8_t h = 0; h < METRICS_HISTOGRAMS; h++) {
+        for (uint8_t b = 0; b < METRICS_BUCKETS; b++) {
+            atomic_init(&cubetas[h][b], 0);
+        }
+    }
+}
+
+void METRICS_Inc(metric_counter contador) {
+    atomic_fetch_add_explicit(&contadores[contador], 1, memory_order_relaxed);
+}
+
+void METRICS_Add(metric_counter contador, uint32_t cantidad) {
+    atomic_fetch_add_explicit(&contadores[contador], cantidad, memory_order_relaxed);
+}
+
+void METRICS_Observe(metric_histogram histograma, uint32_t valor) {
+    atomic_fetch_add_explicit(&cubetas[histograma][cubeta(valor)], 1, memory_order_relaxed);
+}
+
+uint32_t METRICS_GetCounter(metric_counter contador) {
+    return atomic_load_explicit(&contadores[contador], memory_order_relaxed);
+}
+
+uint32_t METRICS_GetBucket(metric_histogram histograma, uint8_t indice) {
+    return atomic_load_explicit(&cubetas[histograma][indice], memory_order_relaxed);
+}
+
+/**
+ * @brief Arma una trama de exportacion con el valor actual de todas las metricas
+ *
+ * @return uint16_t Largo de la trama, 0 si no entra en el buffer
+ */
+uint16_t METRICS_BuildFrame(uint8_t * trama, uint16_t largo, uint32_t now_ms) {
+    if (largo < METRICS_FRAME_LEN) {
+        return 0;
+    }
+
+    uint8_t * p = trama;
+    memcpy(p, METRICS_FRAME_MAGIC, 4);
+    p[4] = METRICS_FRAME_VERSION;
+    p[5] = METRICS_COUNTERS;
+    p[6] = METRICS_HISTOGRAMS;
+    p[7] = METRICS_BUCKETS;
+    p = BYTES_PutU32(&p[8], secuencia++);
+    p = BYTES_PutU32(p, now_ms);
+    for (uint8_t i = 0; i < METRICS_COUNTERS; i++) {
+        p = BYTES_PutU32(p, METRICS_GetCounter(i));
+    }
+    for (uint8_t h = 0; h < METRICS_HISTOGRAMS; h++) {
+        for (uint8_t b = 0; b < METRICS_BUCKETS; b++) {
+            p = BYTES_PutU32(p, METRICS_GetBucket(h, b));
+        }
+    }
+    p = BYTES_PutU32(p, BYTES_Crc32(trama, (size_t)(p - trama)));
+    return (uint16_t)(p - trama);
+}
+
+/*Se llama desde el lazo principal, nunca desde una interrupcion*/
+void METRICS_Service(uint32_t now_ms) {
+    static uint8_t trama[METRICS_FRAME_LEN];
+
+    if (salida == NULL) {
+        return;
+    }
+    if (salida->pedido != NULL ? !salida->pedido()
+                               : now_ms - ultimo_envio < METRICS_EXPORT_PERIOD_MS) {
+        return;
+    }
+    ultimo_envio = now_ms;
+    salida->enviar(trama, METRICS_BuildFrame(trama, sizeof(trama), now_ms));
+}
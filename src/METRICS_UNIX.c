@@ -0,0 +1,73 @@
+/*
+ * METRICS_UNIX.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "METRICS_UNIX.h"
+
+#ifdef __linux__
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static int socket_metricas = -1;
+static struct sockaddr_un colector;
+static socklen_t largo_colector;
+
+static bool leer_pedido(void) {
+    uint8_t descartado[16];
+    bool pedido = false;
+
+    /*Varios pedidos acumulados se responden con una sola trama*/
+    for (;;) {
+        largo_colector = sizeof(colector);
+        if (recvfrom(socket_metricas, descartado, sizeof(descartado), MSG_DONTWAIT,
+                     (struct sockaddr *)&colector, &largo_colector) < 0) {
+            return pedido;
+        }
+        pedido = largo_colector > sizeof(sa_family_t); // Sin direccion no hay a quien responder
+    }
+}
+
+static void enviar_trama(const uint8_t * trama, uint16_t largo) {
+    sendto(socket_metricas, trama, largo, MSG_DONTWAIT, (struct sockaddr *)&colector,
+           largo_colector);
+}
+
+static const metrics_sink salida_unix = {leer_pedido, enviar_trama};
+
+const metrics_sink * METRICS_UNIX_Open(const char * path) {
+    struct sockaddr_un direccion = {.sun_family = AF_UNIX};
+
+    METRICS_UNIX_Close();
+    if (strlen(path) >= sizeof(direccion.sun_path)) {
+        return NULL;
+    }
+    strcpy(direccion.sun_path, path);
+    unlink(path); // Lo deja una ejecucion anterior
+
+    socket_metricas = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (socket_metricas < 0) {
+        return NULL;
+    }
+    if (bind(socket_metricas, (struct sockaddr *)&direccion, sizeof(direccion)) < 0) {
+        METRICS_UNIX_Close();
+        return NULL;
+    }
+    return &salida_unix;
+}
+
+int METRICS_UNIX_GetFd(void) {
+    return socket_metricas;
+}
+
+void METRICS_UNIX_Close(void) {
+    if (socket_metricas >= 0) {
+        close(socket_metricas);
+        socket_metricas = -1;
+    }
+}
+#endif
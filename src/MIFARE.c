@@ -0,0 +1,158 @@
+/*
+ * MIFARE.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "MIFARE.h"
+#include <stddef.h>
+#include <string.h>
+#include "RC522.h"
+#include "METRICS.h"
+
+#define ATQA_LEN      2
+#define UID_BCC_LEN   (MIFARE_UID_LEN + 1)
+#define NVB_ANTICOLL  0x20 // Solo el codigo de comando, la tarjeta completa los 40 bits
+#define NVB_SELECT    0x70 // UID completo + BCC
+#define REQA_BITS     7    // REQA/WUPA son tramas cortas de 7 bits
+
+static const mifare_pcd * lector = NULL;
+static uint32_t (*reloj)(void);
+static mifare_stats estadisticas;
+
+void MIFARE_Init(const mifare_pcd * pcd, uint32_t (*reloj_us)(void)) {
+    lector = pcd;
+    reloj = reloj_us;
+    memset(&estadisticas, 0, sizeof(estadisticas));
+}
+
+mifare_status MIFARE_Request(uint8_t modo, uint8_t * atqa) {
+    uint8_t largo = ATQA_LEN;
+    mifare_status estado = lector->transceive(&modo, 1, REQA_BITS, false, atqa, &largo);
+    return estado == MIFARE_OK && largo != ATQA_LEN ? MIFARE_ERR : estado;
+}
+
+/*Un solo nivel de cascada: UID de 4 bytes, como las tarjetas que se entregan*/
+mifare_status MIFARE_Anticoll(uint8_t * uid_bcc) {
+    const uint8_t trama[] = {PICC_ANTICOLL, NVB_ANTICOLL};
+    uint8_t largo = UID_BCC_LEN;
+
+    mifare_status estado = lector->transceive(trama, sizeof(trama), 0, false, uid_bcc, &largo);
+    if (estado != MIFARE_OK) {
+        return estado;
+    }
+    uint8_t bcc = 0;
+    for (uint8_t i = 0; i < MIFARE_UID_LEN; i++) {
+        bcc ^= uid_bcc[i];
+    }
+    return largo == UID_BCC_LEN && bcc == uid_bcc[MIFARE_UID_LEN] ? MIFARE_OK : MIFARE_ERR;
+}
+
+/*La trama de select se arma directo con la respuesta de la anticolision, que ya trae el BCC*/
+mifare_status MIFARE_SelectTag(const uint8_t * uid_bcc, uint8_t * sak) {
+    uint8_t trama[2 + UID_BCC_LEN] = {PICC_SElECTTAG, NVB_SELECT};
+    uint8_t largo = 1;
+
+    memcpy(&trama[2], uid_bcc, UID_BCC_LEN);
+    mifare_status estado = lector->transceive(trama, sizeof(trama), 0, true, sak, &largo);
+    return estado == MIFARE_OK && largo != 1 ? MIFARE_ERR : estado;
+}
+
+mifare_status MIFARE_Auth(uint8_t modo, uint8_t bloque, const uint8_t * clave,
+                          const uint8_t * uid) {
+    return lector->authenticate(modo, bloque, clave, uid);
+}
+
+mifare_status MIFARE_Read(uint8_t bloque, uint8_t * datos) {
+    const uint8_t trama[] = {PICC_READ, bloque};
+    uint8_t largo = MIFARE_BLOCK_SIZE;
+
+    mifare_status estado = lector->transceive(trama, sizeof(trama), 0, true, datos, &largo);
+    return estado == MIFARE_OK && largo != MIFARE_BLOCK_SIZE ? MIFARE_ERR : estado;
+}
+
+void MIFARE_Halt(void) {
+    const uint8_t trama[] = {PICC_HALT, 0x00};
+
+    lector->transceive(trama, sizeof(trama), 0, true, NULL, NULL); // La tarjeta no responde
+    lector->release();
+}
+
+/*Request, anticolision y select seguidos, sin nada en el medio que espere al lector*/
+static mifare_status seleccionar(uint8_t * uid_bcc) {
+    uint8_t atqa[ATQA_LEN];
+    uint8_t sak;
+
+    mifare_status estado = MIFARE_Request(PICC_REQIDL, atqa);
+    if (estado == MIFARE_OK) {
+        estado = MIFARE_Anticoll(uid_bcc);
+    }
+    if (estado == MIFARE_OK) {
+        estado = MIFARE_SelectTag(uid_bcc, &sak);
+    }
+    return estado;
+}
+
+/*Una autenticacion abre todo el sector; no hace falta repetirla entre bloques*/
+static mifare_status leer_bloques(const uint8_t * uid_bcc, uint8_t sector, uint8_t primero,
+                                  uint8_t cantidad, const uint8_t * clave, uint8_t * datos) {
+    uint8_t bloque = (uint8_t)(sector * MIFARE_BLOCKS_PER_SECT);
+    mifare_status estado = MIFARE_Auth(PICC_AUTHENT1A, bloque, clave, uid_bcc);
+
+    bloque = (uint8_t)(bloque + primero);
+    for (uint8_t i = 0; i < cantidad && estado == MIFARE_OK; i++) {
+        estado = MIFARE_Read((uint8_t)(bloque + i), &datos[i * MIFARE_BLOCK_SIZE]);
+    }
+    return estado;
+}
+
+static void registrar(uint32_t demora) {
+    METRICS_Observe(METRIC_HIST_CARD_READ_US, demora);
+    estadisticas.lecturas++;
+    estadisticas.ultima_us = demora;
+    if (demora > estadisticas.maxima_us) {
+        estadisticas.maxima_us = demora;
+    }
+}
+
+/**
+ * @brief Lee una credencial de los bloques de datos de un sector
+ *
+ * Cada lectura hace el handshake completo. No se reutiliza la seleccion de una lectura anterior:
+ * el REQA de get_RFID_event_ocurrence saca a la tarjeta del estado ACTIVE y al terminar se apaga
+ * Crypto1 para que ese REQA salga en claro.
+ *
+ * @param sector Sector de la credencial (0 a MIFARE_SECTORS - 1)
+ * @param primero Primer bloque dentro del sector, sin contar el trailer
+ * @param cantidad Bloques a leer, datos tiene que tener lugar para cantidad * MIFARE_BLOCK_SIZE
+ * @param clave Clave A del sector
+ * @param uid Recibe el UID de la tarjeta leida
+ * @return mifare_status
+ */
+mifare_status MIFARE_ReadCredential(uint8_t sector, uint8_t primero, uint8_t cantidad,
+                                    const uint8_t * clave, uint8_t * uid, uint8_t * datos) {
+    if (sector >= MIFARE_SECTORS || cantidad == 0 || primero + cantidad > MIFARE_DATA_BLOCKS) {
+        return MIFARE_ERR; // El trailer no se lee nunca
+    }
+
+    uint32_t inicio = reloj();
+    uint8_t uid_bcc[UID_BCC_LEN];
+    mifare_status estado = seleccionar(uid_bcc);
+    if (estado == MIFARE_OK) {
+        estado = leer_bloques(uid_bcc, sector, primero, cantidad, clave, datos);
+    }
+
+    lector->release();
+    if (estado != MIFARE_OK) {
+        estadisticas.fallidas++;
+        return estado;
+    }
+    memcpy(uid, uid_bcc, MIFARE_UID_LEN);
+    registrar(reloj() - inicio);
+    return MIFARE_OK;
+}
+
+const mifare_stats * MIFARE_GetStats(void) {
+    return &estadisticas;
+}
@@ -0,0 +1,151 @@
+/*
+ * MIFARE_RC522.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "MIFARE_RC522.h"
+#include <stddef.h>
+#include "RC522.h"
+#include "SPI.h"
+#include "METRICS.h"
+
+#define DIRECCION_ESCRITURA(reg) (((reg) << 1) & 0x7E)
+#define DIRECCION_LECTURA(reg)   (DIRECCION_ESCRITURA(reg) | 0x80)
+
+#define IRQ_TIMER      0x01
+#define IRQ_IDLE       0x10
+#define IRQ_RX         0x20
+#define IRQ_LIMPIAR    0x7F // Set1 = 0: borra todas las banderas
+#define FIFO_FLUSH     0x80
+#define START_SEND     0x80
+#define CRC_EN         0x80 // TxCRCEn / RxCRCEn
+#define MF_CRYPTO1_ON  0x08
+#define ERRORES        0x1F // ProtocolErr, ParityErr, CRCErr, CollErr, BufferOvfl
+#define AUTH_TRAMA_LEN (2 + MIFARE_KEY_LEN + MIFARE_UID_LEN)
+
+static bool crc_activo;
+
+static void escribir(uint8_t reg, uint8_t valor) {
+    SPI_TransmitReceiveBlocking(DIRECCION_ESCRITURA(reg), 1, SPI_CONTINUE_COM);
+    SPI_TransmitReceiveBlocking(valor, 1, SPI_END_COM);
+}
+
+static uint8_t leer(uint8_t reg) {
+    SPI_TransmitReceiveBlocking(DIRECCION_LECTURA(reg), 1, SPI_CONTINUE_COM);
+    return SPI_TransmitReceiveBlocking(0x00, 1, SPI_END_COM);
+}
+
+/*Rafagas sobre la FIFO: la direccion va una sola vez (escritura) o se encadena con el dato
+ * anterior (lectura), con un unico CS. n + 1 bytes en el bus en lugar de 2n*/
+static void escribir_fifo(const uint8_t * datos, uint8_t n) {
+    SPI_TransmitReceiveBlocking(DIRECCION_ESCRITURA(FIFODataReg), 1, SPI_CONTINUE_COM);
+    for (uint8_t i = 0; i < n; i++) {
+        SPI_TransmitReceiveBlocking(datos[i], 1, i + 1 == n ? SPI_END_COM : SPI_CONTINUE_COM);
+    }
+}
+
+static void leer_fifo(uint8_t * datos, uint8_t n) {
+    if (n == 0) {
+        return; // Sin un ultimo byte con SPI_END_COM el CS quedaria activo
+    }
+    SPI_TransmitReceiveBlocking(DIRECCION_LECTURA(FIFODataReg), 1, SPI_CONTINUE_COM);
+    for (uint8_t i = 0; i < n; i++) {
+        bool ultimo = i + 1 == n;
+        datos[i] = SPI_TransmitReceiveBlocking(ultimo ? 0x00 : DIRECCION_LECTURA(FIFODataReg), 1,
+                                               ultimo ? SPI_END_COM : SPI_CONTINUE_COM);
+    }
+}
+
+/*El CRC lo calcula y verifica el RC522 al vuelo, sin un PCD_CALCCRC con su espera por trama. Solo
+ * se tocan los registros cuando cambia respecto de la trama anterior*/
+static void configurar_crc(bool activo) {
+    if (activo == crc_activo) {
+        return;
+    }
+    escribir(TxModeReg, activo ? CRC_EN : 0x00);
+    escribir(RxModeReg, activo ? CRC_EN : 0x00);
+    crc_activo = activo;
+}
+
+static mifare_status ejecutar(uint8_t comando, const uint8_t * tx, uint8_t tx_len,
+                              uint8_t bits_finales, uint8_t * rx, uint8_t * rx_len) {
+    uint8_t esperado = comando == PCD_AUTHENT ? IRQ_IDLE : IRQ_RX | IRQ_IDLE;
+    uint16_t consultas = 0;
+    uint8_t irq;
+
+    escribir(CommandReg, PCD_IDLE);
+    escribir(CommIrqReg, IRQ_LIMPIAR);
+    escribir(FIFOLevelReg, FIFO_FLUSH);
+    escribir_fifo(tx, tx_len);
+    escribir(CommandReg, comando);
+    escribir(BitFramingReg, comando == PCD_TRANSCEIVE ? START_SEND | bits_finales : bits_finales);
+
+    do {
+        irq = leer(CommIrqReg);
+    } while (!(irq & (esperado | IRQ_TIMER)) && ++consultas < MIFARE_RC522_MAX_POLLS);
+    escribir(BitFramingReg, 0x00);
+
+    if (!(irq & esperado)) {
+        METRICS_Inc(METRIC_RC522_TIMEOUTS);
+        return MIFARE_NO_TAG;
+    }
+    if (leer(ErrorReg) & ERRORES) {
+        return MIFARE_ERR;
+    }
+    if (rx == NULL) {
+        return MIFARE_OK;
+    }
+
+    uint8_t recibidos = leer(FIFOLevelReg);
+    if (recibidos > *rx_len) {
+        return MIFARE_ERR;
+    }
+    leer_fifo(rx, recibidos);
+    *rx_len = recibidos;
+    return MIFARE_OK;
+}
+
+static mifare_status transceive(const uint8_t * tx, uint8_t tx_len, uint8_t bits_finales, bool crc,
+                                uint8_t * rx, uint8_t * rx_len) {
+    configurar_crc(crc);
+    return ejecutar(PCD_TRANSCEIVE, tx, tx_len, bits_finales, rx, rx_len);
+}
+
+static mifare_status authenticate(uint8_t modo, uint8_t bloque, const uint8_t * clave,
+                                  const uint8_t * uid) {
+    uint8_t trama[AUTH_TRAMA_LEN] = {modo, bloque};
+
+    for (uint8_t i = 0; i < MIFARE_KEY_LEN; i++) {
+        trama[2 + i] = clave[i];
+    }
+    for (uint8_t i = 0; i < MIFARE_UID_LEN; i++) {
+        trama[2 + MIFARE_KEY_LEN + i] = uid[i];
+    }
+
+    /*Con una clave equivocada la tarjeta no contesta, igual que si se retiro o se apoyo otra: el
+     * timeout se informa como MIFARE_NO_TAG*/
+    mifare_status estado = ejecutar(PCD_AUTHENT, trama, sizeof(trama), 0, NULL, NULL);
+    if (estado != MIFARE_OK) {
+        return estado;
+    }
+    return leer(Status2Reg) & MF_CRYPTO1_ON ? MIFARE_OK : MIFARE_AUTH_ERR;
+}
+
+static void stop_crypto(void) {
+    escribir(Status2Reg, leer(Status2Reg) & (uint8_t)~MF_CRYPTO1_ON);
+}
+
+static void release(void) {
+    stop_crypto();
+    configurar_crc(false);
+}
+
+static const mifare_pcd lector_rc522 = {transceive, authenticate, release};
+
+const mifare_pcd * MIFARE_RC522_Init(void) {
+    crc_activo = true; // Fuerza a dejar los registros en un estado conocido
+    configurar_crc(false);
+    return &lector_rc522;
+}
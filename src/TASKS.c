@@ -0,0 +1,129 @@
+/*
+ * TASKS.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "TASKS.h"
+#include <stddef.h>
+#include <string.h>
+
+typedef struct {
+    task_fn tarea; // NULL si la ranura esta libre
+    task_ctx ctx;
+    bool lista;    // Cedio con TASK_YIELD, puede seguir sin esperar nada
+} ranura_tarea;
+
+static ranura_tarea tareas[TASKS_MAX];
+static uint32_t (*reloj)(void);
+
+static ranura_tarea * buscar(task_fn tarea) {
+    for (uint8_t i = 0; i < TASKS_MAX; i++) {
+        if (tareas[i].tarea == tarea) {
+            return &tareas[i];
+        }
+    }
+    return NULL;
+}
+
+/*Devuelve true si la tarea sigue pendiente*/
+static bool reanudar(ranura_tarea * ranura, bool * avanzo) {
+    task_fn tarea = ranura->tarea;
+    task_result resultado = tarea(&ranura->ctx);
+
+    if (ranura->tarea != tarea) {
+        return false; // Se cancelo a si misma
+    }
+    if (resultado == TASK_ENDED) {
+        ranura->tarea = NULL;
+        return false;
+    }
+    ranura->lista = resultado == TASK_YIELDED;
+    *avanzo = *avanzo || ranura->lista;
+    return true;
+}
+
+void TASKS_Init(uint32_t (*reloj_us)(void)) {
+    reloj = reloj_us;
+    memset(tareas, 0, sizeof(tareas));
+}
+
+/**
+ * @brief Inicia una corrutina y corre su primer tramo en el momento
+ *
+ * Si la tarea no tiene que esperar termina aca mismo, igual que una rutina de accion comun. Si ya
+ * estaba en curso se reinicia desde el principio.
+ *
+ * @return false si no habia lugar para dejarla pendiente
+ */
+bool TASKS_Start(task_fn tarea) {
+    ranura_tarea * ranura = buscar(tarea);
+    if (ranura == NULL) {
+        ranura = buscar(NULL);
+    }
+    if (ranura == NULL) {
+        return false;
+    }
+
+    ranura->tarea = tarea;
+    ranura->ctx.linea = 0;
+    bool avanzo = false;
+    reanudar(ranura, &avanzo);
+    return true;
+}
+
+void TASKS_Cancel(task_fn tarea) {
+    ranura_tarea * ranura = buscar(tarea);
+    if (ranura != NULL && tarea != NULL) {
+        ranura->tarea = NULL;
+    }
+}
+
+/**
+ * @brief Reanuda las tareas pendientes dentro del presupuesto de tiempo de esta vuelta del lazo
+ *
+ * Todas las tareas se reanudan al menos una vez. Mientras alguna ceda con TASK_YIELD y quede
+ * presupuesto se hacen mas pasadas; las que esperan una condicion se vuelven a mirar en la
+ * proxima vuelta.
+ *
+ * @return uint8_t Tareas que siguen pendientes
+ */
+uint8_t TASKS_Run(uint32_t presupuesto_us) {
+    uint32_t inicio = reloj();
+    uint8_t pendientes;
+    bool avanzo;
+
+    do {
+        pendientes = 0;
+        avanzo = false;
+        for (uint8_t i = 0; i < TASKS_MAX; i++) {
+            if (tareas[i].tarea != NULL && reanudar(&tareas[i], &avanzo)) {
+                pendientes++;
+            }
+        }
+    } while (avanzo && reloj() - inicio < presupuesto_us);
+
+    return pendientes;
+}
+
+/*Tareas que se quedaron sin presupuesto y no hay que esperar nada para reanudarlas*/
+uint8_t TASKS_Ready(void) {
+    uint8_t listas = 0;
+    for (uint8_t i = 0; i < TASKS_MAX; i++) {
+        if (tareas[i].tarea != NULL && tareas[i].lista) {
+            listas++;
+        }
+    }
+    return listas;
+}
+
+uint8_t TASKS_Pending(void) {
+    uint8_t pendientes = 0;
+    for (uint8_t i = 0; i < TASKS_MAX; i++) {
+        if (tareas[i].tarea != NULL) {
+            pendientes++;
+        }
+    }
+    return pendientes;
+}
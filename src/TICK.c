@@ -0,0 +1,36 @@
+/*
+ * TICK.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "TICK.h"
+
+#ifdef __linux__
+#include <time.h>
+
+static uint64_t tick_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000U + (uint64_t)ts.tv_nsec;
+}
+
+uint32_t TICK_GetMs(void) {
+    return (uint32_t)(tick_ns() / 1000000U);
+}
+
+uint32_t TICK_GetUs(void) {
+    return (uint32_t)(tick_ns() / 1000U);
+}
+#else
+#include "stm32f4xx_hal.h"
+
+uint32_t TICK_GetMs(void) {
+    return HAL_GetTick();
+}
+
+uint32_t TICK_GetUs(void) {
+    return HAL_GetTick() * 1000U; // El SysTick solo tiene resolucion de 1 ms
+}
+#endif
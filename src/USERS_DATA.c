@@ -0,0 +1,86 @@
+/*
+ * USERS_DATA.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "USERS_DATA.h"
+#include <string.h>
+#include "USERS_INDEX.h"
+#include "USERS_VALIDATOR.h"
+#include "TICK.h"
+
+/*Tabla de usuarios compilada, es la version 1 del indice local. Las altas, bajas y modificaciones
+ * posteriores llegan como deltas (USERS_INDEX_BeginDelta)*/
+static const user usuarios[MAX_USERS] = {{{0x93, 0x2A, 0x4C, 0x1B}, {1, 2, 3, 4}},
+                                         {{0x6B, 0xF1, 0x07, 0xA2}, {4, 3, 2, 1}}};
+static const uint8_t cantidad_usuarios = 2;
+
+static KeyCard ultima_tarjeta;
+static bool tarjeta_validada = false;
+static uint32_t usuario_actual = USERS_DATA_NO_USER_ID;
+static PIN pin_esperado;
+static PIN pin_ingresado;
+
+void USERS_DATA_INIT(void) {
+    USERS_INDEX_Init(usuarios, cantidad_usuarios);
+    tarjeta_validada = false;
+    usuario_actual = USERS_DATA_NO_USER_ID;
+    memset(pin_esperado, 0, sizeof(pin_esperado));
+    memset(pin_ingresado, 0, sizeof(pin_ingresado));
+    memset(ultima_tarjeta, 0, sizeof(ultima_tarjeta));
+}
+
+bool USERS_DATA_VALIDATE_KEYCARD(uint8_t * KeyCardReaded) {
+    users_entry local;
+    bool en_indice = USERS_INDEX_Lookup(KeyCardReaded, &local);
+
+    memcpy(ultima_tarjeta, KeyCardReaded, sizeof(KeyCard));
+    usuario_actual = en_indice ? local.UserId : USERS_DATA_NO_USER_ID;
+    switch (USERS_VALIDATOR_Lookup(KeyCardReaded, pin_esperado, TICK_GetMs())) {
+    case VALIDATOR_ALLOW:
+        tarjeta_validada = true;
+        break;
+    case VALIDATOR_DENY:
+        tarjeta_validada = false;
+        break;
+    default: // Sin respuesta del servidor: se decide con la tabla local
+        tarjeta_validada = en_indice;
+        if (tarjeta_validada) {
+            memcpy(pin_esperado, local.UserPin, sizeof(PIN));
+        }
+        break;
+    }
+    return tarjeta_validada;
+}
+
+uint32_t USERS_DATA_GET_CURRENT_USER_ID(void) {
+    return usuario_actual;
+}
+
+/*La ultima tarjeta validada quedo con una consulta al servidor en vuelo: volver a validarla
+ * cuando deje de estar pendiente da la decision del servidor en lugar de la tabla local*/
+bool USERS_DATA_KEYCARD_PENDING(void) {
+    return USERS_VALIDATOR_Pending(ultima_tarjeta);
+}
+
+bool USERS_DATA_VALIDATE_PIN(void) {
+    return tarjeta_validada && memcmp(pin_ingresado, pin_esperado, sizeof(PIN)) == 0;
+}
+
+void USERS_DATA_COLLECT_FIRST_NUMBER(uint8_t * PIN_FirstNumber) {
+    pin_ingresado[0] = *PIN_FirstNumber;
+}
+
+void USERS_DATA_COLLECT_SECOND_NUMBER(uint8_t * PIN_SecondNumber) {
+    pin_ingresado[1] = *PIN_SecondNumber;
+}
+
+void USERS_DATA_COLLECT_THIRD_NUMBER(uint8_t * PIN_ThirdNumber) {
+    pin_ingresado[2] = *PIN_ThirdNumber;
+}
+
+void USERS_DATA_COLLECT_FOURTH_NUMBER(uint8_t * PIN_FourtNumber) {
+    pin_ingresado[3] = *PIN_FourtNumber;
+}
@@ -0,0 +1,319 @@
+/*
+ * USERS_INDEX.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "USERS_INDEX.h"
+#include <stdatomic.h>
+#include <stddef.h>
+#include <string.h>
+#include "USERS_MATCH.h"
+#include "ACCESS_RULES.h"
+#include "BYTES.h"
+
+/*Estructura de arreglos: la columna de UIDs queda contigua para compararla de a muchos a la vez*/
+typedef struct {
+    uint32_t version;
+    uint32_t cantidad;
+    uint32_t uids[USERS_INDEX_MAX_ENTRIES]; // Ordenados, empaquetados con USERS_MATCH_PackUid
+    PIN pines[USERS_INDEX_MAX_ENTRIES];
+    uint32_t ids[USERS_INDEX_MAX_ENTRIES];
+} users_snapshot;
+
+/*Se lee siempre desde la copia activa. El delta se aplica sobre la otra y al terminar se
+ * intercambia el puntero. Antes de pisar una copia se espera a que no queden lectores en ella.
+ * El lector anota su banco y vuelve a leer activo; el escritor publica activo y despues lee los
+ * lectores. Son dos pares escritura->lectura cruzados, por eso esos cuatro accesos son seq_cst:
+ * con acquire/release cada lado podria no ver la escritura del otro*/
+static users_snapshot bancos[2];
+static users_snapshot * _Atomic activo = &bancos[0];
+static atomic_uint lectores[2];
+
+static struct {
+    users_sync_status estado;
+    const uint8_t * registros;
+    uint32_t cantidad;
+    uint32_t version_nueva;
+    uint32_t leidos;          // Registros del delta ya consumidos
+    uint32_t copiados;        // Usuarios de la version activa ya consumidos
+    users_snapshot * origen;
+    users_snapshot * destino;
+    bool destino_libre;       // Paso el periodo de gracia, ya se puede pisar el destino
+    uint32_t bajas[USERS_INDEX_MAX_ENTRIES]; // Ids que dejan de existir con la version nueva
+    uint32_t cantidad_bajas;
+    access_id_change renumerados[USERS_INDEX_MAX_ENTRIES]; // Usuarios que siguen con otro id
+    uint32_t cantidad_renumerados;
+} sync;
+
+static unsigned banco(const users_snapshot * snapshot) {
+    return snapshot == &bancos[0] ? 0 : 1;
+}
+
+static int32_t buscar(const users_snapshot * snapshot, uint32_t uid) {
+    if (snapshot->cantidad <= USERS_INDEX_LINEAR_MAX) {
+        return USERS_MATCH_Find(snapshot->uids, snapshot->cantidad, uid);
+    }
+
+    uint32_t inicio = 0;
+    uint32_t fin = snapshot->cantidad;
+    while (inicio < fin) {
+        uint32_t medio = inicio + (fin - inicio) / 2;
+        if (snapshot->uids[medio] == uid) {
+            return (int32_t)medio;
+        }
+        if (snapshot->uids[medio] < uid) {
+            inicio = medio + 1;
+        } else {
+            fin = medio;
+        }
+    }
+    return USERS_MATCH_NOT_FOUND;
+}
+
+static void copiar_usuario(const users_snapshot * snapshot, int32_t pos, users_entry * usuario) {
+    uint32_t uid = snapshot->uids[pos];
+    usuario->UserKeyCard[0] = (uint8_t)(uid >> 24);
+    usuario->UserKeyCard[1] = (uint8_t)(uid >> 16);
+    usuario->UserKeyCard[2] = (uint8_t)(uid >> 8);
+    usuario->UserKeyCard[3] = (uint8_t)uid;
+    memcpy(usuario->UserPin, snapshot->pines[pos], sizeof(PIN));
+    usuario->UserId = snapshot->ids[pos];
+}
+
+/*Se anota como lector de la copia activa y confirma que no fue reemplazada mientras tanto*/
+static users_snapshot * entrar_lector(void) {
+    for (;;) {
+        users_snapshot * snapshot = atomic_load_explicit(&activo, memory_order_acquire);
+        unsigned b = banco(snapshot);
+        atomic_fetch_add_explicit(&lectores[b], 1, memory_order_seq_cst);
+        if (atomic_load_explicit(&activo, memory_order_seq_cst) == snapshot) {
+            return snapshot;
+        }
+        atomic_fetch_sub_explicit(&lectores[b], 1, memory_order_release);
+    }
+}
+
+static void salir_lector(const users_snapshot * snapshot) {
+    atomic_fetch_sub_explicit(&lectores[banco(snapshot)], 1, memory_order_release);
+}
+
+void USERS_INDEX_Init(const user * usuarios, uint32_t cantidad) {
+    users_snapshot * snapshot = &bancos[0];
+
+    USERS_MATCH_Init();
+    memset(&sync, 0, sizeof(sync));
+    snapshot->version = 1;
+    snapshot->cantidad = 0;
+    for (uint32_t i = 0; i < cantidad && snapshot->cantidad < USERS_INDEX_MAX_ENTRIES; i++) {
+        /*Insercion ordenada, la tabla compilada es chica*/
+        uint32_t uid = USERS_MATCH_PackUid(usuarios[i].UserKeyCard);
+        uint32_t pos = 0;
+        while (pos < snapshot->cantidad && snapshot->uids[pos] < uid) {
+            pos++;
+        }
+        if (pos < snapshot->cantidad && snapshot->uids[pos] == uid) {
+            continue; // UID repetido, vale el primero
+        }
+        for (uint32_t j = snapshot->cantidad; j > pos; j--) {
+            snapshot->uids[j] = snapshot->uids[j - 1];
+            memcpy(snapshot->pines[j], snapshot->pines[j - 1], sizeof(PIN));
+            snapshot->ids[j] = snapshot->ids[j - 1];
+        }
+        snapshot->uids[pos] = uid;
+        memcpy(snapshot->pines[pos], usuarios[i].UserPin, sizeof(PIN));
+        snapshot->ids[pos] = i;
+        snapshot->cantidad++;
+    }
+    atomic_store_explicit(&activo, snapshot, memory_order_release);
+}
+
+bool USERS_INDEX_Lookup(const uint8_t * KeyCardReaded, users_entry * encontrado) {
+    users_snapshot * snapshot = entrar_lector();
+
+    int32_t pos = buscar(snapshot, USERS_MATCH_PackUid(KeyCardReaded));
+    if (pos != USERS_MATCH_NOT_FOUND && encontrado != NULL) {
+        copiar_usuario(snapshot, pos, encontrado);
+    }
+
+    salir_lector(snapshot);
+    return pos != USERS_MATCH_NOT_FOUND;
+}
+
+/*Auditoria de muchas tarjetas contra la misma version del indice*/
+void USERS_INDEX_LookupBatch(const KeyCard * tarjetas, uint32_t cantidad, bool * presentes) {
+    uint32_t uids[USERS_INDEX_BATCH];
+    int32_t posiciones[USERS_INDEX_BATCH];
+
+    for (uint32_t inicio = 0; inicio < cantidad; inicio += USERS_INDEX_BATCH) {
+        uint32_t lote = cantidad - inicio < USERS_INDEX_BATCH ? cantidad - inicio
+                                                              : USERS_INDEX_BATCH;
+        for (uint32_t j = 0; j < lote; j++) {
+            uids[j] = USERS_MATCH_PackUid(tarjetas[inicio + j]);
+        }
+
+        users_snapshot * snapshot = entrar_lector();
+        if (snapshot->cantidad <= USERS_INDEX_LINEAR_MAX) {
+            USERS_MATCH_Batch(snapshot->uids, snapshot->cantidad, uids, lote, posiciones);
+        } else {
+            for (uint32_t j = 0; j < lote; j++) {
+                posiciones[j] = buscar(snapshot, uids[j]);
+            }
+        }
+        salir_lector(snapshot);
+
+        for (uint32_t j = 0; j < lote; j++) {
+            presentes[inicio + j] = posiciones[j] != USERS_MATCH_NOT_FOUND;
+        }
+    }
+}
+
+uint32_t USERS_INDEX_GetVersion(void) {
+    return atomic_load_explicit(&activo, memory_order_acquire)->version;
+}
+
+uint32_t USERS_INDEX_GetCount(void) {
+    return atomic_load_explicit(&activo, memory_order_acquire)->cantidad;
+}
+
+/**
+ * @brief Empieza a aplicar un delta sobre la version activa del indice
+ *
+ * El delta no se copia: SyncStep lo va leyendo de a pasos, asi que el buffer tiene que seguir
+ * valido y sin cambios hasta que SyncStep devuelva USERS_SYNC_DONE o USERS_SYNC_ERROR. Solo se
+ * acepta un delta armado sobre la version activa y que la haga avanzar: uno viejo no puede
+ * volver el indice atras.
+ *
+ * @return users_sync_status USERS_SYNC_BUSY si quedo en curso, USERS_SYNC_ERROR si se rechazo
+ */
+users_sync_status USERS_INDEX_BeginDelta(const uint8_t * delta, uint32_t len) {
+    if (sync.estado == USERS_SYNC_BUSY) {
+        return USERS_SYNC_ERROR;
+    }
+    if (len < USERS_DELTA_HEADER_LEN || memcmp(delta, USERS_DELTA_MAGIC, 4) != 0) {
+        return USERS_SYNC_ERROR;
+    }
+
+    users_snapshot * origen = atomic_load_explicit(&activo, memory_order_acquire);
+    uint32_t cantidad = BYTES_GetU32(&delta[12]);
+
+    if (BYTES_GetU32(&delta[4]) != origen->version || BYTES_GetU32(&delta[8]) <= origen->version ||
+        (len - USERS_DELTA_HEADER_LEN) / USERS_DELTA_RECORD_LEN < cantidad) {
+        return USERS_SYNC_ERROR;
+    }
+
+    sync.estado = USERS_SYNC_BUSY;
+    sync.registros = &delta[USERS_DELTA_HEADER_LEN];
+    sync.cantidad = cantidad;
+    sync.version_nueva = BYTES_GetU32(&delta[8]);
+    sync.leidos = 0;
+    sync.copiados = 0;
+    sync.origen = origen;
+    sync.destino = &bancos[1 - banco(origen)];
+    sync.destino_libre = false;
+    sync.cantidad_bajas = 0;
+    sync.cantidad_renumerados = 0;
+    return USERS_SYNC_BUSY;
+}
+
+static bool agregar(uint32_t uid, const uint8_t * pin, uint32_t id) {
+    users_snapshot * destino = sync.destino;
+
+    if (destino->cantidad >= USERS_INDEX_MAX_ENTRIES) {
+        return false;
+    }
+    destino->uids[destino->cantidad] = uid;
+    memcpy(destino->pines[destino->cantidad], pin, sizeof(PIN));
+    destino->ids[destino->cantidad] = id;
+    destino->cantidad++;
+    return true;
+}
+
+/*Un paso del merge entre la version activa y el delta. Devuelve false si el delta es invalido*/
+static bool mezclar_un_paso(void) {
+    const users_snapshot * origen = sync.origen;
+    const uint8_t * registro = NULL;
+    uint32_t uid = 0;
+
+    if (sync.leidos < sync.cantidad) {
+        registro = &sync.registros[sync.leidos * USERS_DELTA_RECORD_LEN];
+        uid = USERS_MATCH_PackUid(&registro[1]);
+        if (sync.leidos > 0 && USERS_MATCH_PackUid(&registro[1 - USERS_DELTA_RECORD_LEN]) >= uid) {
+            return false; // Delta desordenado o con UID repetidos
+        }
+    }
+
+    int orden;
+    if (registro == NULL) {
+        orden = -1;
+    } else if (sync.copiados == origen->cantidad) {
+        orden = 1;
+    } else {
+        uint32_t actual = origen->uids[sync.copiados];
+        orden = actual < uid ? -1 : actual > uid ? 1 : 0;
+    }
+
+    if (orden < 0) {
+        uint32_t i = sync.copiados++;
+        return agregar(origen->uids[i], origen->pines[i], origen->ids[i]);
+    }
+
+    sync.leidos++;
+
+    switch (registro[0]) {
+    case USERS_DELTA_ADD:
+        return orden > 0 && agregar(uid, &registro[5], BYTES_GetU32(&registro[9]));
+    case USERS_DELTA_MODIFY:
+        if (orden == 0 && origen->ids[sync.copiados] != BYTES_GetU32(&registro[9])) {
+            access_id_change * cambio = &sync.renumerados[sync.cantidad_renumerados++];
+            cambio->viejo = origen->ids[sync.copiados];
+            cambio->nuevo = BYTES_GetU32(&registro[9]); // El horario sigue al usuario
+        }
+        sync.copiados++;
+        return orden == 0 && agregar(uid, &registro[5], BYTES_GetU32(&registro[9]));
+    case USERS_DELTA_REMOVE:
+        if (orden != 0) {
+            return false;
+        }
+        sync.bajas[sync.cantidad_bajas++] = origen->ids[sync.copiados++];
+        return true;
+    default:
+        return false;
+    }
+}
+
+users_sync_status USERS_INDEX_SyncStep(uint32_t budget) {
+    if (sync.estado != USERS_SYNC_BUSY) {
+        return sync.estado;
+    }
+
+    /*Periodo de gracia: todavia hay lecturas en curso sobre la copia que se va a pisar*/
+    if (!sync.destino_libre) {
+        if (atomic_load_explicit(&lectores[banco(sync.destino)], memory_order_seq_cst) != 0) {
+            return USERS_SYNC_BUSY;
+        }
+        sync.destino->cantidad = 0;
+        sync.destino_libre = true;
+    }
+
+    while (budget-- > 0) {
+        if (sync.leidos == sync.cantidad && sync.copiados == sync.origen->cantidad) {
+            sync.destino->version = sync.version_nueva;
+            atomic_store_explicit(&activo, sync.destino, memory_order_seq_cst);
+            /*Recien ahora: hasta la publicacion la version anterior seguia aceptando a estos
+             * usuarios y sin su horario quedarian sin restricciones*/
+            for (uint32_t i = 0; i < sync.cantidad_bajas; i++) {
+                ACCESS_RULES_Remove(sync.bajas[i]);
+            }
+            ACCESS_RULES_Renumber(sync.renumerados, sync.cantidad_renumerados);
+            sync.estado = USERS_SYNC_DONE;
+            return sync.estado;
+        }
+        if (!mezclar_un_paso()) {
+            sync.estado = USERS_SYNC_ERROR;
+            return sync.estado;
+        }
+    }
+    return USERS_SYNC_BUSY;
+}
@@ -0,0 +1,196 @@
+/*
+ * USERS_MATCH.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "USERS_MATCH.h"
+#include <stddef.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__) // i386 sin -msse2: escalar
+#include <immintrin.h>
+#define USERS_MATCH_X86
+#elif defined(__ARM_FEATURE_MVE) && (__ARM_FEATURE_MVE & 1)
+#include <arm_mve.h>
+#define USERS_MATCH_MVE
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USERS_MATCH_NEON
+#endif
+
+typedef int32_t (*buscador)(const uint32_t *, uint32_t, uint32_t);
+
+/*El UID se empaqueta en big endian para que el orden numerico coincida con el de memcmp*/
+uint32_t USERS_MATCH_PackUid(const uint8_t * uid) {
+    return (uint32_t)uid[0] << 24 | (uint32_t)uid[1] << 16 | (uint32_t)uid[2] << 8 | uid[3];
+}
+
+int32_t USERS_MATCH_FindScalar(const uint32_t * columna, uint32_t cantidad, uint32_t uid) {
+    for (uint32_t i = 0; i < cantidad; i++) {
+        if (columna[i] == uid) {
+            return (int32_t)i;
+        }
+    }
+    return USERS_MATCH_NOT_FOUND;
+}
+
+#if defined(USERS_MATCH_X86)
+/*16 UIDs por iteracion: cuatro comparaciones de 4 lanes y un unico salto*/
+static int32_t buscar_sse2(const uint32_t * columna, uint32_t cantidad, uint32_t uid) {
+    const __m128i clave = _mm_set1_epi32((int)uid);
+    uint32_t i = 0;
+
+    for (; i + 16 <= cantidad; i += 16) {
+        const __m128i * p = (const __m128i *)&columna[i];
+        __m128i a = _mm_cmpeq_epi32(_mm_loadu_si128(p + 0), clave);
+        __m128i b = _mm_cmpeq_epi32(_mm_loadu_si128(p + 1), clave);
+        __m128i c = _mm_cmpeq_epi32(_mm_loadu_si128(p + 2), clave);
+        __m128i d = _mm_cmpeq_epi32(_mm_loadu_si128(p + 3), clave);
+        __m128i algun = _mm_or_si128(_mm_or_si128(a, b), _mm_or_si128(c, d));
+        if (_mm_movemask_epi8(algun) != 0) {
+            uint32_t mascara = (uint32_t)_mm_movemask_epi8(a) |
+                               (uint32_t)_mm_movemask_epi8(b) << 16;
+            if (mascara == 0) {
+                mascara = (uint32_t)_mm_movemask_epi8(c) | (uint32_t)_mm_movemask_epi8(d) << 16;
+                return (int32_t)(i + 8 + ((uint32_t)__builtin_ctz(mascara) >> 2));
+            }
+            return (int32_t)(i + ((uint32_t)__builtin_ctz(mascara) >> 2));
+        }
+    }
+    int32_t resto = USERS_MATCH_FindScalar(&columna[i], cantidad - i, uid);
+    return resto < 0 ? resto : (int32_t)i + resto;
+}
+
+/*32 UIDs por iteracion con registros de 8 lanes*/
+__attribute__((target("avx2"))) static int32_t buscar_avx2(const uint32_t * columna,
+                                                           uint32_t cantidad, uint32_t uid) {
+    const __m256i clave = _mm256_set1_epi32((int)uid);
+    uint32_t i = 0;
+
+    for (; i + 32 <= cantidad; i += 32) {
+        const __m256i * p = (const __m256i *)&columna[i];
+        __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 0), clave);
+        __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 1), clave);
+        __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 2), clave);
+        __m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256(p + 3), clave);
+        __m256i algun = _mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d));
+        if (!_mm256_testz_si256(algun, algun)) {
+            const __m256i grupos[4] = {a, b, c, d};
+            for (uint32_t g = 0; g < 4; g++) {
+                uint32_t mascara = (uint32_t)_mm256_movemask_epi8(grupos[g]);
+                if (mascara != 0) {
+                    return (int32_t)(i + 8 * g + ((uint32_t)__builtin_ctz(mascara) >> 2));
+                }
+            }
+        }
+    }
+    /*El resto se resuelve sin salir de AVX: mezclar con codigo SSE sin VEX penaliza la transicion*/
+    for (; i + 8 <= cantidad; i += 8) {
+        __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256((const __m256i *)&columna[i]), clave);
+        uint32_t mascara = (uint32_t)_mm256_movemask_epi8(a);
+        if (mascara != 0) {
+            return (int32_t)(i + ((uint32_t)__builtin_ctz(mascara) >> 2));
+        }
+    }
+    int32_t resto = USERS_MATCH_FindScalar(&columna[i], cantidad - i, uid);
+    return resto < 0 ? resto : (int32_t)i + resto;
+}
+#elif defined(USERS_MATCH_MVE)
+/*Helium: el predicado de comparacion tiene 4 bits por lane de 32 bits*/
+static int32_t buscar_mve(const uint32_t * columna, uint32_t cantidad, uint32_t uid) {
+    uint32_t i = 0;
+
+    for (; i + 16 <= cantidad; i += 16) {
+        mve_pred16_t a = vcmpeqq_n_u32(vld1q_u32(&columna[i + 0]), uid);
+        mve_pred16_t b = vcmpeqq_n_u32(vld1q_u32(&columna[i + 4]), uid);
+        mve_pred16_t c = vcmpeqq_n_u32(vld1q_u32(&columna[i + 8]), uid);
+        mve_pred16_t d = vcmpeqq_n_u32(vld1q_u32(&columna[i + 12]), uid);
+        if ((a | b | c | d) != 0) {
+            uint64_t mascara = (uint64_t)a | (uint64_t)b << 16 | (uint64_t)c << 32 |
+                               (uint64_t)d << 48;
+            return (int32_t)(i + ((uint32_t)__builtin_ctzll(mascara) >> 2));
+        }
+    }
+    int32_t resto = USERS_MATCH_FindScalar(&columna[i], cantidad - i, uid);
+    return resto < 0 ? resto : (int32_t)i + resto;
+}
+#elif defined(USERS_MATCH_NEON)
+static int32_t buscar_neon(const uint32_t * columna, uint32_t cantidad, uint32_t uid) {
+    const uint32x4_t clave = vdupq_n_u32(uid);
+    uint32_t i = 0;
+
+    for (; i + 16 <= cantidad; i += 16) {
+        uint32x4_t a = vceqq_u32(vld1q_u32(&columna[i + 0]), clave);
+        uint32x4_t b = vceqq_u32(vld1q_u32(&columna[i + 4]), clave);
+        uint32x4_t c = vceqq_u32(vld1q_u32(&columna[i + 8]), clave);
+        uint32x4_t d = vceqq_u32(vld1q_u32(&columna[i + 12]), clave);
+        uint32x4_t algun = vorrq_u32(vorrq_u32(a, b), vorrq_u32(c, d));
+        uint32x2_t mitad = vorr_u32(vget_low_u32(algun), vget_high_u32(algun));
+        if ((vget_lane_u32(mitad, 0) | vget_lane_u32(mitad, 1)) != 0) {
+            return (int32_t)i + USERS_MATCH_FindScalar(&columna[i], 16, uid);
+        }
+    }
+    int32_t resto = USERS_MATCH_FindScalar(&columna[i], cantidad - i, uid);
+    return resto < 0 ? resto : (int32_t)i + resto;
+}
+#endif
+
+/*Hasta USERS_MATCH_Init se busca en forma escalar: nunca hay un puntero sin inicializar*/
+static buscador buscar = USERS_MATCH_FindScalar;
+static const char * implementacion = "scalar";
+
+/**
+ * @brief Elige la busqueda vectorizada que soporta el procesador
+ *
+ * Se llama una vez al arrancar, antes de que haya lectores del indice en otros hilos: despues
+ * buscar solo se lee y no hace falta sincronizarlo.
+ */
+void USERS_MATCH_Init(void) {
+#if defined(USERS_MATCH_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        buscar = buscar_avx2;
+        implementacion = "avx2";
+    } else {
+        buscar = buscar_sse2;
+        implementacion = "sse2";
+    }
+#elif defined(USERS_MATCH_MVE)
+    buscar = buscar_mve;
+    implementacion = "mve";
+#elif defined(USERS_MATCH_NEON)
+    buscar = buscar_neon;
+    implementacion = "neon";
+#endif
+}
+
+int32_t USERS_MATCH_Find(const uint32_t * columna, uint32_t cantidad, uint32_t uid) {
+    return buscar(columna, cantidad, uid);
+}
+
+/*Recorre la columna por bloques que entran en cache y prueba contra cada bloque todos los UIDs
+ * que todavia no se encontraron*/
+void USERS_MATCH_Batch(const uint32_t * columna, uint32_t cantidad, const uint32_t * uids,
+                       uint32_t cantidad_uids, int32_t * posiciones) {
+    for (uint32_t j = 0; j < cantidad_uids; j++) {
+        posiciones[j] = USERS_MATCH_NOT_FOUND;
+    }
+    for (uint32_t bloque = 0; bloque < cantidad; bloque += USERS_MATCH_BLOCK) {
+        uint32_t largo = cantidad - bloque < USERS_MATCH_BLOCK ? cantidad - bloque
+                                                                : USERS_MATCH_BLOCK;
+        for (uint32_t j = 0; j < cantidad_uids; j++) {
+            if (posiciones[j] != USERS_MATCH_NOT_FOUND) {
+                continue;
+            }
+            int32_t pos = buscar(&columna[bloque], largo, uids[j]);
+            if (pos != USERS_MATCH_NOT_FOUND) {
+                posiciones[j] = (int32_t)bloque + pos;
+            }
+        }
+    }
+}
+
+const char * USERS_MATCH_GetImplementation(void) {
+    return implementacion;
+}
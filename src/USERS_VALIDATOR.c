@@ -0,0 +1,146 @@
+/*
+ * USERS_VALIDATOR.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#include "USERS_VALIDATOR.h"
+#include <stddef.h>
+#include <string.h>
+
+_Static_assert(VALIDATOR_REFRESH_MS < VALIDATOR_TTL_MS &&
+                   VALIDATOR_NEGATIVE_REFRESH_MS < VALIDATOR_NEGATIVE_TTL_MS,
+               "El refresco anticipado tiene que ocurrir antes de que venza la decision");
+
+typedef struct {
+    uint8_t uid[4];
+    uint8_t pin[4];
+    bool ocupada;
+    bool consultando;           // Hay una consulta en vuelo para esta tarjeta
+    validator_verdict decision; // VALIDATOR_UNKNOWN mientras no llego ninguna respuesta
+    uint32_t respondida;        // Momento en que se recibio la decision
+    uint32_t consultada;        // Momento en que se envio la ultima consulta
+    uint32_t uso;               // Orden de uso para el reemplazo LRU
+} entrada_cache;
+
+static const users_validator_backend * servicio = NULL;
+static entrada_cache cache[VALIDATOR_CACHE_SIZE];
+static uint32_t contador_uso = 0;
+
+static entrada_cache * buscar(const uint8_t * uid) {
+    for (int i = 0; i < VALIDATOR_CACHE_SIZE; i++) {
+        if (cache[i].ocupada && memcmp(cache[i].uid, uid, sizeof(cache[i].uid)) == 0) {
+            return &cache[i];
+        }
+    }
+    return NULL;
+}
+
+static entrada_cache * reservar(const uint8_t * uid) {
+    entrada_cache * victima = &cache[0];
+
+    for (int i = 0; i < VALIDATOR_CACHE_SIZE; i++) {
+        if (!cache[i].ocupada) {
+            victima = &cache[i];
+            break;
+        }
+        if (cache[i].uso < victima->uso) {
+            victima = &cache[i];
+        }
+    }
+    memset(victima, 0, sizeof(*victima));
+    memcpy(victima->uid, uid, sizeof(victima->uid));
+    victima->ocupada = true;
+    victima->decision = VALIDATOR_UNKNOWN;
+    return victima;
+}
+
+static void consultar(entrada_cache * entrada, uint32_t now) {
+    if (entrada->consultando) {
+        return;
+    }
+    if (servicio->request(entrada->uid)) {
+        entrada->consultando = true;
+        entrada->consultada = now;
+    }
+}
+
+static uint32_t vida_util(const entrada_cache * entrada) {
+    return entrada->decision == VALIDATOR_ALLOW ? VALIDATOR_TTL_MS : VALIDATOR_NEGATIVE_TTL_MS;
+}
+
+static uint32_t edad_de_refresco(const entrada_cache * entrada) {
+    return entrada->decision == VALIDATOR_ALLOW ? VALIDATOR_REFRESH_MS
+                                                : VALIDATOR_NEGATIVE_REFRESH_MS;
+}
+
+void USERS_VALIDATOR_Init(const users_validator_backend * backend) {
+    servicio = backend;
+    contador_uso = 0;
+    memset(cache, 0, sizeof(cache));
+}
+
+/*Nunca espera al servidor: responde desde la cache o devuelve VALIDATOR_UNKNOWN y deja la consulta
+ * en vuelo para que la respuesta este disponible en la proxima lectura*/
+validator_verdict USERS_VALIDATOR_Lookup(const uint8_t * uid, uint8_t * pin, uint32_t now) {
+    if (servicio == NULL) {
+        return VALIDATOR_UNKNOWN;
+    }
+
+    entrada_cache * entrada = buscar(uid);
+    if (entrada == NULL) {
+        entrada = reservar(uid);
+    }
+    entrada->uso = ++contador_uso;
+
+    if (entrada->decision != VALIDATOR_UNKNOWN) {
+        uint32_t edad = now - entrada->respondida;
+        if (edad < vida_util(entrada)) {
+            if (edad >= edad_de_refresco(entrada)) {
+                consultar(entrada, now); // Refresco anticipado, se sigue usando la decision vigente
+            }
+            memcpy(pin, entrada->pin, sizeof(entrada->pin));
+            return entrada->decision;
+        }
+        entrada->decision = VALIDATOR_UNKNOWN; // Vencida
+    }
+
+    consultar(entrada, now);
+    return VALIDATOR_UNKNOWN;
+}
+
+void USERS_VALIDATOR_Poll(uint32_t now) {
+    if (servicio == NULL) {
+        return;
+    }
+
+    uint8_t uid[4];
+    uint8_t pin[4];
+    validator_verdict decision;
+
+    while (servicio->poll(uid, &decision, pin)) {
+        entrada_cache * entrada = buscar(uid);
+        if (entrada == NULL || !entrada->consultando) {
+            continue; // No pedida, vencida o de una tarjeta desalojada: no ocupa lugar en la cache
+        }
+        entrada->consultando = false;
+        if (decision == VALIDATOR_UNKNOWN) {
+            continue;
+        }
+        entrada->decision = decision;
+        entrada->respondida = now;
+        memcpy(entrada->pin, pin, sizeof(entrada->pin));
+    }
+
+    for (int i = 0; i < VALIDATOR_CACHE_SIZE; i++) {
+        if (cache[i].consultando && now - cache[i].consultada >= VALIDATOR_RESPONSE_TIMEOUT_MS) {
+            cache[i].consultando = false; // Servidor lento, se reintenta en la proxima lectura
+        }
+    }
+}
+
+bool USERS_VALIDATOR_Pending(const uint8_t * uid) {
+    entrada_cache * entrada = buscar(uid);
+    return entrada != NULL && entrada->consultando;
+}
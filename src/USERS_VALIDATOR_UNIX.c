@@ -0,0 +1,84 @@
+/*
+ * USERS_VALIDATOR_UNIX.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: agent
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE // struct ucred
+#endif
+#include "USERS_VALIDATOR_UNIX.h"
+
+#ifdef __linux__
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static int socket_servidor = -1;
+
+static bool enviar_consulta(const uint8_t * uid) {
+    ssize_t enviados = send(socket_servidor, uid, VALIDATOR_UNIX_REQUEST_LEN, MSG_DONTWAIT);
+    return enviados == VALIDATOR_UNIX_REQUEST_LEN;
+}
+
+static bool leer_respuesta(uint8_t * uid, validator_verdict * verdict, uint8_t * pin) {
+    uint8_t trama[VALIDATOR_UNIX_RESPONSE_LEN];
+
+    if (recv(socket_servidor, trama, sizeof(trama), MSG_DONTWAIT) != (ssize_t)sizeof(trama)) {
+        return false;
+    }
+    memcpy(uid, &trama[0], 4);
+    *verdict = trama[4] ? VALIDATOR_ALLOW : VALIDATOR_DENY;
+    memcpy(pin, &trama[5], 4);
+    return true;
+}
+
+static const users_validator_backend backend_unix = {enviar_consulta, leer_respuesta};
+
+/*El kernel informa quien hizo bind del otro lado: cualquier usuario puede escuchar en un camino
+ * al que tenga acceso, pero no hacerse pasar por root*/
+static bool servidor_confiable(int fd) {
+    struct ucred credenciales;
+    socklen_t largo = sizeof(credenciales);
+
+    if (getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credenciales, &largo) < 0 ||
+        largo != sizeof(credenciales)) {
+        return false;
+    }
+    return credenciales.uid == VALIDATOR_UNIX_SERVER_UID;
+}
+
+const users_validator_backend * USERS_VALIDATOR_UNIX_Open(const char * path) {
+    struct sockaddr_un direccion = {.sun_family = AF_UNIX};
+
+    USERS_VALIDATOR_UNIX_Close();
+    if (strlen(path) >= sizeof(direccion.sun_path)) {
+        return NULL;
+    }
+    strcpy(direccion.sun_path, path);
+
+    socket_servidor = socket(AF_UNIX, SOCK_SEQPACKET, 0);
+    if (socket_servidor < 0) {
+        return NULL;
+    }
+    if (connect(socket_servidor, (struct sockaddr *)&direccion, sizeof(direccion)) < 0 ||
+        !servidor_confiable(socket_servidor)) {
+        USERS_VALIDATOR_UNIX_Close();
+        return NULL;
+    }
+    return &backend_unix;
+}
+
+int USERS_VALIDATOR_UNIX_GetFd(void) {
+    return socket_servidor;
+}
+
+void USERS_VALIDATOR_UNIX_Close(void) {
+    if (socket_servidor >= 0) {
+        close(socket_servidor);
+        socket_servidor = -1;
+    }
+}
+#endif
@@ -26,20 +26,424 @@ SPDX-License-Identifier: MIT
 /* === Headers files inclusions =============================================================== */
 
 #include "main.h"
+#include "ACCESS_RULES.h"
+#include "BOOT.h"
+#include "FSM.h"
+#include "FSM_IMAGE.h"
+#include "FSM_RETAIN.h"
+#include "IDLE.h"
+#include "RC522.h"
+#include "TASKS.h"
+#include "SPI.h"
+#include "TTP229.h"
+#include "LED.h"
+#include "LOCKOUT.h"
+#include "METRICS.h"
+#include "METRICS_UNIX.h"
+#include "TIMER.h"
+#include "USERS_DATA.h"
+#include "USERS_VALIDATOR.h"
+#include "USERS_VALIDATOR_UNIX.h"
+#include "TICK.h"
+#include <stddef.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include "stm32f4xx.h" // RCC->CSR
+#endif
 /* === Macros definitions ====================================================================== */
 
+#ifdef __linux__
+/*En la simulacion la RAM retenida es un archivo en memoria compartida que sobrevive al proceso*/
+#define RETAIN_SHM_PATH "/dev/shm/tsse_fsm_retain"
+#define RETAIN_SHM_SIZE 4096
+/*Servidor de credenciales local que reemplaza al servidor central en la simulacion*/
+#define VALIDATOR_SOCKET_PATH "/run/tsse/validator.sock"
+/*Donde el colector local pide las tramas de metricas. El directorio es privado (del mismo usuario
+ * y sin permisos para nadie mas): solo un colector del mismo usuario puede pedir tramas*/
+#define METRICS_SOCKET_DIR  "/run/tsse-metrics"
+#define METRICS_SOCKET_PATH METRICS_SOCKET_DIR "/metrics.sock"
+/*Tablas de la FSM que se cargan al arrancar y cada vez que llega SIGHUP. El CRC solo detecta
+ * errores: el directorio y el archivo tienen que ser de root y no escribibles por nadie mas*/
+#define FSM_IMAGE_DIR  "/etc/tsse"
+#define FSM_IMAGE_FILE "fsm.img"
+#endif
+
+/*Grupo de puertas al que pertenece este controlador, contra el que se chequean los horarios*/
+#define DOOR_GROUP 0x0001U
+/*Cada cuanto se vuelve a leer la hora local para los horarios de acceso*/
+#define ACCESS_TIME_PERIOD_MS 1000U
+
+/*Tiempo maximo por vuelta del lazo: lo que no use el evento lo usan las corrutinas pendientes*/
+#define LOOP_BUDGET_US 2000U
+
 /* === Private data type declarations ========================================================== */
 
+enum {
+    STAGE_SPI,
+    STAGE_RC522,
+    STAGE_KEYBOARD,
+    STAGE_TIMERS,
+    STAGE_USERS,
+    STAGE_LEDS,
+    STAGE_VALIDATOR,
+    STAGE_COUNT
+};
+
 /* === Private variable declarations =========================================================== */
 
 /* === Private function declarations =========================================================== */
 
+static void * retained_storage(void);
+static fsm_reset_cause reset_cause(void);
+static void open_metrics(void);
+static void init_users(void);
+static void update_access_time(void);
+static void connect_validator(void);
+static bool timer_expired(void);
+static void print_boot_timeline(void);
+static void print_idle_stats(void);
+static void load_fsm_image(void);
+static const STATE * resume_session(uint8_t state_id, const fsm_pendientes * pending);
+static const STATE * boot(void);
+static void save_session(const STATE * state);
+static const STATE * swap_tables(const STATE * state);
+static void run_tasks(uint32_t loop_start);
+static void sleep_until_next_event(void);
+
 /* === Public variable definitions ============================================================= */
 
 /* === Private variable definitions ============================================================ */
 
+/*MFRC522_Init hace sus esperas de reset y de antena adentro (bloqueante). Los leds son criticos:
+ * LED_OPEN_DOOR maneja la cerradura y la FSM los usa desde el primer evento. El servidor remoto no
+ * hace falta para leer la primera tarjeta y se completa con la FSM ya en marcha*/
+static const boot_stage boot_stages[STAGE_COUNT] = {
+    [STAGE_SPI] = {"spi", SPI_Init, 0, false},
+    [STAGE_RC522] = {"rc522", MFRC522_Init, BOOT_STAGE(STAGE_SPI), false},
+    [STAGE_KEYBOARD] = {"teclado", KEYBOAD_Init, 0, false},
+    [STAGE_TIMERS] = {"timers", TIMERS_Init, 0, false},
+    [STAGE_USERS] = {"usuarios", init_users, 0, false},
+    [STAGE_LEDS] = {"leds", LED_Init, 0, false},
+    [STAGE_VALIDATOR] = {"validador", connect_validator, BOOT_STAGE(STAGE_USERS), true},
+};
+
+/*Feriados del anio en curso, como dia del anio desde 0 = 1 de enero (2026, no bisiesto)*/
+static const uint16_t holidays[] = {0, 120, 358};
+
+static bool warm_start = false;
+static bool boot_deferred_done = false;
+
+#ifdef __linux__
+static volatile sig_atomic_t image_requested = 1;
+#endif
+
 /* === Private function implementation ========================================================= */
 
+static void * retained_storage(void) {
+#ifdef __linux__
+    int fd = open(RETAIN_SHM_PATH, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return NULL;
+    }
+    if (ftruncate(fd, RETAIN_SHM_SIZE) < 0) {
+        close(fd);
+        return NULL;
+    }
+    void * memory = mmap(NULL, RETAIN_SHM_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    return memory == MAP_FAILED ? NULL : memory;
+#else
+    return NULL;
+#endif
+}
+
+#ifdef __linux__
+/*Lo crea si no existe. Uno que ya existia solo se usa si es un directorio propio sin permisos
+ * para el grupo ni para otros*/
+static bool private_directory(const char * path) {
+    struct stat info;
+    if (mkdir(path, 0700) < 0 && errno != EEXIST) {
+        return false;
+    }
+    int dir = open(path, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    if (dir < 0) {
+        return false;
+    }
+    bool private = fstat(dir, &info) == 0 && info.st_uid == geteuid() &&
+                   (info.st_mode & (S_IRWXG | S_IRWXO)) == 0;
+    close(dir);
+    return private;
+}
+#endif
+
+/*En la simulacion el proceso que se vuelve a lanzar equivale a un reset por software. En el equipo
+ * se leen las banderas de RCC->CSR y se borran para el proximo reset. Un encendido tambien marca
+ * BORRSTF y PINRSTF, y cualquier reset interno marca PINRSTF, de ahi el orden de las preguntas*/
+static fsm_reset_cause reset_cause(void) {
+#ifdef __linux__
+    return FSM_RESET_SOFTWARE;
+#else
+    uint32_t flags = RCC->CSR;
+    RCC->CSR |= RCC_CSR_RMVF;
+    if (flags & (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF)) {
+        return flags & RCC_CSR_PORRSTF ? FSM_RESET_POWER_ON : FSM_RESET_BROWNOUT;
+    }
+    if (flags & (RCC_CSR_IWDGRSTF | RCC_CSR_WWDGRSTF)) {
+        return FSM_RESET_WATCHDOG;
+    }
+    return flags & RCC_CSR_SFTRSTF ? FSM_RESET_SOFTWARE : FSM_RESET_PIN;
+#endif
+}
+
+static void open_metrics(void) {
+#ifdef __linux__
+    if (!private_directory(METRICS_SOCKET_DIR)) {
+        printf("metricas: %s no es un directorio privado, no se exportan\n", METRICS_SOCKET_DIR);
+        METRICS_Init(NULL);
+        return;
+    }
+    METRICS_Init(METRICS_UNIX_Open(METRICS_SOCKET_PATH));
+    IDLE_WatchFd(METRICS_UNIX_GetFd()); // Un pedido del colector despierta el lazo
+#else
+    METRICS_Init(NULL); // Sin driver de UART en el arbol: solo quedan los contadores en RAM
+#endif
+}
+
+/*Primero la puerta, los feriados y la hora. La tabla compilada no trae horarios: los usuarios sin
+ * horario cargado no tienen restricciones*/
+static void init_users(void) {
+    ACCESS_RULES_Init(DOOR_GROUP);
+    for (uint8_t i = 0; i < sizeof(holidays) / sizeof(holidays[0]); i++) {
+        ACCESS_RULES_SetHoliday(holidays[i], true);
+    }
+    update_access_time();
+    USERS_DATA_INIT();
+}
+
+/*En la simulacion la hora sale del reloj del sistema. En el equipo la da el RTC, cuyo driver no
+ * esta en este arbol: hasta que este la hora queda sin fijar y los usuarios con horario no entran*/
+static void update_access_time(void) {
+#ifdef __linux__
+    static uint32_t last_update_ms;
+    static bool updated = false;
+    uint32_t now = TICK_GetMs();
+
+    if (updated && now - last_update_ms < ACCESS_TIME_PERIOD_MS) {
+        return;
+    }
+    updated = true;
+    last_update_ms = now;
+    time_t seconds = time(NULL);
+    struct tm local;
+    localtime_r(&seconds, &local);
+    ACCESS_RULES_SetTime((uint8_t)((local.tm_wday + 6) % 7), // tm_wday: 0 = domingo
+                         (uint16_t)(local.tm_hour * 60 + local.tm_min), (uint16_t)local.tm_yday);
+#endif
+}
+
+#ifdef __linux__
+static void request_fsm_image(int signal) {
+    (void)signal;
+    image_requested = 1;
+}
+
+/*Se chequea sobre el descriptor ya abierto, asi no se puede cambiar el archivo entre el chequeo y
+ * la lectura*/
+static bool owned_by_root(int fd, mode_t type) {
+    struct stat info;
+    return fstat(fd, &info) == 0 && (info.st_mode & S_IFMT) == type && info.st_uid == 0 &&
+           (info.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+static ssize_t read_fsm_image(uint8_t * image, size_t size) {
+    ssize_t length = -1;
+    int dir = open(FSM_IMAGE_DIR, O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    if (dir < 0) {
+        return -1;
+    }
+    int file = openat(dir, FSM_IMAGE_FILE, O_RDONLY | O_NOFOLLOW);
+    if (file >= 0) {
+        if (owned_by_root(dir, S_IFDIR) && owned_by_root(file, S_IFREG)) {
+            length = read(file, image, size);
+        } else {
+            printf("tablas %s/%s: permisos inseguros, se ignoran\n", FSM_IMAGE_DIR,
+                   FSM_IMAGE_FILE);
+        }
+        close(file);
+    }
+    close(dir);
+    return length;
+}
+#endif
+
+/*En el equipo la imagen llega por el canal de administracion, que no esta en este arbol*/
+static void load_fsm_image(void) {
+#ifdef __linux__
+    static uint8_t image[FSM_IMAGE_LEN(FSM_IMAGE_MAX_EDGES)];
+
+    if (!image_requested) {
+        return;
+    }
+    image_requested = 0;
+    ssize_t length = read_fsm_image(image, sizeof(image));
+    if (length < 0) {
+        return;
+    }
+    fsm_image_status status = FSM_IMAGE_Load(image, (uint16_t)length);
+    printf("tablas %s/%s: %s\n", FSM_IMAGE_DIR, FSM_IMAGE_FILE,
+           status == FSM_IMAGE_OK ? "validas, se activan en reposo" : "rechazadas");
+#endif
+}
+
+static void connect_validator(void) {
+#ifdef __linux__
+    USERS_VALIDATOR_Init(USERS_VALIDATOR_UNIX_Open(VALIDATOR_SOCKET_PATH));
+    IDLE_WatchFd(USERS_VALIDATOR_UNIX_GetFd()); // Las respuestas del servidor despiertan el lazo
+#else
+    USERS_VALIDATOR_Init(NULL);
+#endif
+}
+
+/*El timeout lo avisa el TIM10 por bandera, se revisa antes de dormir y en cada despertar*/
+static bool timer_expired(void) {
+    return TIME_GetTimeStatus(TIMER_TIMEOUT) != 0;
+}
+
+static void print_boot_timeline(void) {
+#ifdef __linux__
+    const boot_timeline_entry * timeline = BOOT_GetTimeline();
+    const fsm_retain_stats * stats = FSM_RETAIN_GetStats();
+
+    printf("arranque %s: frio %u us (%u), caliente %u us (%u)\n",
+           warm_start ? "caliente" : "frio", stats->ultimo_frio_us, stats->arranques_frios,
+           stats->ultimo_caliente_us, stats->arranques_calientes);
+    for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+        if (timeline[i].omitida) {
+            printf("  %-10s omitida\n", boot_stages[i].nombre);
+        } else {
+            printf("  %-10s %8u -> %8u us%s\n", boot_stages[i].nombre, timeline[i].inicio_us,
+                   timeline[i].lista_us, boot_stages[i].diferida ? " (diferida)" : "");
+        }
+    }
+#endif
+}
+
+static void print_idle_stats(void) {
+#ifdef __linux__
+    const idle_stats * stats = IDLE_GetStats();
+    printf("reposo: ciclo util %u.%u%%, %u despertares/s\n", stats->ciclo_util_permil / 10U,
+           stats->ciclo_util_permil % 10U, stats->despertares_por_seg);
+#endif
+}
+
+/*Solo se retiene la FSM: la tarjeta y el PIN de USERS_DATA se pierden con USERS_DATA_INIT, asi
+ * que una sesion a medio hacer terminaria en PIN_INVALIDO. Se retoma solo con la puerta cerrada o
+ * abierta; en el resto de los estados se vuelve a pedir la tarjeta*/
+static const STATE * resume_session(uint8_t state_id, const fsm_pendientes * pending) {
+    const STATE * state = FSM_GetStateById(state_id);
+
+    if (state != estado_puerta_cerrada && state != estado_puerta_abierta) {
+        return FSM_GetInitState();
+    }
+    FSM_RestorePending(pending);
+    if (state == estado_puerta_abierta) {
+        LED_OPEN_DOOR(); // La salida de la cerradura vuelve a su estado de reset con el micro
+    }
+    return state;
+}
+
+/**
+ * @brief Inicializa los perifericos y decide entre arranque en frio o retomar la sesion guardada
+ *
+ * En un arranque en caliente (reset por watchdog o por software con la RAM retenida valida) el
+ * RC522 conserva su configuracion porque no se resetea junto con el micro, asi que no se vuelve a
+ * inicializar. Los perifericos internos si vuelven a su estado de reset y se inicializan siempre.
+ *
+ * @return STATE* Estado desde el que arranca la maquina de estados
+ */
+static const STATE * boot(void) {
+    uint32_t start = TICK_GetUs();
+    fsm_pendientes pending;
+    uint8_t state_id;
+    const STATE * state;
+
+    FSM_RETAIN_Init(retained_storage(), reset_cause());
+    warm_start = FSM_RETAIN_Restore(&state_id, &pending);
+    IDLE_Init(TICK_GetUs, timer_expired);
+    TASKS_Init(TICK_GetUs);
+    LOCKOUT_Init(TICK_GetMs); // Solo en RAM: un reinicio levanta los bloqueos
+    open_metrics();
+
+    BOOT_Init(boot_stages, STAGE_COUNT, TICK_GetUs);
+    if (warm_start && FSM_RETAIN_GetPeripheralsReady()) {
+        BOOT_Skip(STAGE_RC522);
+    }
+    while (!BOOT_Step()) {
+    }
+
+    if (warm_start) {
+        state = resume_session(state_id, &pending);
+    } else {
+        state = FSM_GetInitState();
+    }
+    save_session(state);
+    FSM_RETAIN_SetPeripheralsReady(true);
+    FSM_RETAIN_RecordBoot(warm_start, TICK_GetUs() - start);
+    return state;
+}
+
+/*Una imagen cargada no sobrevive al reset: la sesion solo se guarda con las tablas compiladas*/
+static void save_session(const STATE * state) {
+    if (FSM_GetInitState() != estado_puerta_cerrada) {
+        return;
+    }
+    fsm_pendientes pending;
+    FSM_GetPending(&pending);
+    FSM_RETAIN_Save(FSM_GetStateId(state), &pending);
+}
+
+/*Punto seguro: fsm() no esta corriendo y ninguna sesion quedo a medio hacer*/
+static const STATE * swap_tables(const STATE * state) {
+    load_fsm_image();
+    if (!FSM_IMAGE_Pending() || TASKS_Pending() != 0) {
+        return state;
+    }
+    state = FSM_IMAGE_Apply(state);
+    if (!FSM_IMAGE_Pending()) {
+        FSM_RETAIN_Invalidate();
+        save_session(state);
+#ifdef __linux__
+        printf("tablas de la FSM version %u activas\n", FSM_GetTables()->version);
+#endif
+    }
+    return state;
+}
+
+static void run_tasks(uint32_t loop_start) {
+    uint32_t elapsed = TICK_GetUs() - loop_start;
+    TASKS_Run(elapsed < LOOP_BUDGET_US ? LOOP_BUDGET_US - elapsed : 0);
+    METRICS_Inc(METRIC_LOOP_ITERATIONS);
+    METRICS_Observe(METRIC_HIST_LOOP_US, TICK_GetUs() - loop_start);
+}
+
+/*Sin eventos pendientes no tiene sentido volver a encuestar de inmediato: se duerme hasta el
+ * proximo plazo o hasta que una interrupcion (o el socket del servidor en Linux) lo despierte*/
+static void sleep_until_next_event(void) {
+    uint32_t windows = IDLE_GetStats()->ventanas;
+    if (IDLE_Sleep() && IDLE_GetStats()->ventanas != windows) {
+        print_idle_stats();
+    }
+}
+
 /* === Public function implementation ========================================================== */
 
 /**
@@ -49,6 +453,33 @@ SPDX-License-Identifier: MIT
 void Delay(void){};
 
 int main(void) {
+#ifdef __linux__
+    signal(SIGHUP, request_fsm_image);
+#endif
+    const STATE * state = boot();
+
+    while (1) {
+        uint32_t loop_start = TICK_GetUs();
+        update_access_time(); // Antes de get_event: la tarjeta se chequea con la hora de ahora
+        eventos event = get_event();
+        if (event != FIN_TABLA) {
+            state = fsm(state, event);
+            save_session(state);
+        }
+        if (!boot_deferred_done && BOOT_StepDeferred()) {
+            boot_deferred_done = true;
+            print_boot_timeline();
+        }
+        USERS_VALIDATOR_Poll(TICK_GetMs());
+        METRICS_Service(TICK_GetMs());
+        if (event == FIN_TABLA) {
+            state = swap_tables(state);
+        }
+        run_tasks(loop_start);
+        if (event == FIN_TABLA && boot_deferred_done && TASKS_Ready() == 0) {
+            sleep_until_next_event();
+        }
+    }
 
     return 0;
 }
@@ -0,0 +1,199 @@
+#include "unity.h"
+#include "ACCESS_RULES.h"
+
+#define GRUPO_ENTRADA  0x0001U
+#define GRUPO_DEPOSITO 0x0002U
+
+#define LUNES   0
+#define SABADO  5
+#define DOMINGO 6
+
+static const access_window horario_oficina[] = {{ACCESS_WEEKDAYS, 8 * 60, 18 * 60}};
+static const access_window guardia_nocturna[] = {{ACCESS_ALL_DAYS, 22 * 60, 6 * 60}};
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    ACCESS_RULES_Init(GRUPO_ENTRADA);
+}
+
+void test_usuario_sin_horario_no_tiene_restricciones(void) {
+    ACCESS_RULES_SetTime(DOMINGO, 3 * 60, 0);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(ACCESS_RULES_MAX_USERS));
+}
+
+void test_sin_hora_los_usuarios_con_horario_no_entran(void) {
+    const access_window siempre[] = {{ACCESS_ALL_DAYS, 0, 1440}};
+    TEST_ASSERT_TRUE(ACCESS_RULES_Compile(1, siempre, 1, GRUPO_ENTRADA, true));
+
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(2)); // Sin horario no depende de la hora
+    ACCESS_RULES_SetTime(LUNES, 0, 0);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+
+    ACCESS_RULES_Init(GRUPO_ENTRADA); // Reiniciar vuelve a dejar la hora sin fijar
+    ACCESS_RULES_Compile(1, siempre, 1, GRUPO_ENTRADA, true);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+}
+
+void test_horario_de_oficina(void) {
+    TEST_ASSERT_TRUE(ACCESS_RULES_Compile(1, horario_oficina, 1, GRUPO_ENTRADA, false));
+
+    ACCESS_RULES_SetTime(LUNES, 8 * 60, 10);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+    ACCESS_RULES_SetTime(LUNES, 17 * 60 + 59, 10);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+    ACCESS_RULES_SetTime(LUNES, 18 * 60, 10);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+    ACCESS_RULES_SetTime(LUNES, 7 * 60 + 59, 10);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+    ACCESS_RULES_SetTime(SABADO, 10 * 60, 15);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+}
+
+void test_ventana_que_cruza_la_medianoche(void) {
+    ACCESS_RULES_Compile(2, guardia_nocturna, 1, GRUPO_ENTRADA, true);
+
+    ACCESS_RULES_SetTime(DOMINGO, 23 * 60, 0);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(2));
+    ACCESS_RULES_SetTime(LUNES, 5 * 60, 0); // Sigue la guardia del domingo
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(2));
+    ACCESS_RULES_SetTime(LUNES, 12 * 60, 0);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(2));
+}
+
+void test_limites_fuera_de_slot_se_redondean_hacia_adentro(void) {
+    const access_window ventana[] = {{ACCESS_MONDAY, 8 * 60 + 30, 10 * 60 + 30}};
+    ACCESS_RULES_Compile(3, ventana, 1, GRUPO_ENTRADA, false);
+
+    ACCESS_RULES_SetTime(LUNES, 8 * 60 + 45, 0);
+    TEST_ASSERT_EQUAL(ACCESS_RULES_SLOT_MINUTES < 30, ACCESS_RULES_Check(3));
+    ACCESS_RULES_SetTime(LUNES, 9 * 60, 0);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(3));
+}
+
+void test_grupo_de_puertas(void) {
+    ACCESS_RULES_Compile(4, horario_oficina, 1, GRUPO_DEPOSITO, false);
+    ACCESS_RULES_SetTime(LUNES, 9 * 60, 0);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(4));
+
+    ACCESS_RULES_Init(GRUPO_DEPOSITO);
+    ACCESS_RULES_Compile(4, horario_oficina, 1, GRUPO_DEPOSITO, false);
+    ACCESS_RULES_SetTime(LUNES, 9 * 60, 0);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(4));
+}
+
+void test_feriados(void) {
+    ACCESS_RULES_Compile(1, horario_oficina, 1, GRUPO_ENTRADA, false);
+    ACCESS_RULES_Compile(2, guardia_nocturna, 1, GRUPO_ENTRADA, true);
+    ACCESS_RULES_SetHoliday(100, true);
+
+    ACCESS_RULES_SetTime(LUNES, 9 * 60, 100);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+    ACCESS_RULES_SetTime(LUNES, 23 * 60, 100);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(2));
+
+    ACCESS_RULES_SetHoliday(100, false);
+    ACCESS_RULES_SetTime(LUNES, 9 * 60, 100);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+}
+
+void test_baja_de_horario(void) {
+    ACCESS_RULES_Compile(1, horario_oficina, 1, GRUPO_ENTRADA, false);
+    ACCESS_RULES_SetTime(SABADO, 9 * 60, 0);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1));
+    ACCESS_RULES_Remove(1);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+}
+
+void test_ventana_invalida_es_rechazada(void) {
+    const access_window ventana[] = {{ACCESS_MONDAY, 25 * 60, 26 * 60}};
+    TEST_ASSERT_FALSE(ACCESS_RULES_Compile(1, ventana, 1, GRUPO_ENTRADA, false));
+}
+
+void test_ids_grandes_tambien_tienen_horario(void) {
+    const uint32_t id_de_delta = 0x8000002AU;
+    TEST_ASSERT_TRUE(ACCESS_RULES_Compile(id_de_delta, horario_oficina, 1, GRUPO_ENTRADA, false));
+
+    ACCESS_RULES_SetTime(SABADO, 9 * 60, 0);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(id_de_delta));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(0x2A)); // Mismos bits bajos, otro usuario
+}
+
+void test_tabla_llena_rechaza_usuarios_nuevos(void) {
+    for (uint32_t i = 0; i < ACCESS_RULES_MAX_USERS; i++) {
+        TEST_ASSERT_TRUE(ACCESS_RULES_Compile(i * 1000U, horario_oficina, 1, GRUPO_ENTRADA, false));
+    }
+    TEST_ASSERT_FALSE(ACCESS_RULES_Compile(7, horario_oficina, 1, GRUPO_ENTRADA, false));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Compile(0, guardia_nocturna, 1, GRUPO_ENTRADA, false));
+
+    ACCESS_RULES_Remove(3000);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Compile(7, horario_oficina, 1, GRUPO_ENTRADA, false));
+}
+
+void test_bajas_no_mezclan_los_horarios_restantes(void) {
+    ACCESS_RULES_SetTime(SABADO, 23 * 60, 0);
+    for (uint32_t i = 0; i < ACCESS_RULES_MAX_USERS; i++) {
+        const access_window * horario = i % 2 ? guardia_nocturna : horario_oficina;
+        ACCESS_RULES_Compile(i * 7U, horario, 1, GRUPO_ENTRADA, false);
+    }
+    for (uint32_t i = 0; i < ACCESS_RULES_MAX_USERS; i += 3) {
+        ACCESS_RULES_Remove(i * 7U);
+    }
+
+    for (uint32_t i = 0; i < ACCESS_RULES_MAX_USERS; i++) {
+        bool esperado = i % 3 == 0 || i % 2 == 1; // Sin horario o de guardia a las 23
+        TEST_ASSERT_EQUAL(esperado, ACCESS_RULES_Check(i * 7U));
+    }
+}
+
+void test_renumerar_lleva_el_horario_al_id_nuevo(void) {
+    ACCESS_RULES_Compile(1, horario_oficina, 1, GRUPO_ENTRADA, false);
+    ACCESS_RULES_Compile(2, guardia_nocturna, 1, GRUPO_ENTRADA, false);
+    ACCESS_RULES_Compile(7, horario_oficina, 1, GRUPO_ENTRADA, false);
+    const access_id_change cambios[] = {{1, 2}, {2, 1}, {7, 1000007U}};
+    ACCESS_RULES_Renumber(cambios, 3);
+
+    ACCESS_RULES_SetTime(LUNES, 10 * 60, 10);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1)); // Intercambio: 1 tiene ahora la guardia nocturna
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(2));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1000007U));
+    ACCESS_RULES_SetTime(LUNES, 23 * 60, 10);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(2));
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1000007U));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(7)); // El id viejo queda libre
+}
+
+void test_renumerar_en_cadena(void) {
+    ACCESS_RULES_Compile(1, horario_oficina, 1, GRUPO_ENTRADA, false);
+    ACCESS_RULES_Compile(2, guardia_nocturna, 1, GRUPO_ENTRADA, false);
+    const access_id_change cambios[] = {{1, 2}, {2, 3}};
+    ACCESS_RULES_Renumber(cambios, 2);
+
+    ACCESS_RULES_SetTime(LUNES, 10 * 60, 10);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(2));
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(3));
+    ACCESS_RULES_SetTime(LUNES, 23 * 60, 10);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(2));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(3));
+}
+
+void test_renumerado_sin_horario_no_hereda_el_del_id_nuevo(void) {
+    ACCESS_RULES_Compile(5, horario_oficina, 1, GRUPO_ENTRADA, false);
+    const access_id_change cambios[] = {{4, 5}}; // 4 no tiene horario
+    ACCESS_RULES_Renumber(cambios, 1);
+
+    ACCESS_RULES_SetTime(SABADO, 10 * 60, 15);
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(5));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(4));
+}
+
+void test_memoria_por_usuario(void) {
+    // Semana, grupos y marcas, el id de usuario y dos cubetas de la tabla de dispersion
+    TEST_ASSERT_LESS_OR_EQUAL(ACCESS_RULES_WEEK_BYTES + 16, ACCESS_RULES_GetBytesPerUser());
+}
@@ -0,0 +1,101 @@
+#include "unity.h"
+#include "BOOT.h"
+
+enum { ETAPA_BUS, ETAPA_LECTOR, ETAPA_TECLADO, ETAPA_LEDS, CANTIDAD_ETAPAS };
+
+static int orden;
+static int iniciada_en[CANTIDAD_ETAPAS];
+static uint32_t reloj_us;
+
+static uint32_t reloj_falso(void) {
+    return reloj_us;
+}
+
+static void iniciar_bus(void) {
+    iniciada_en[ETAPA_BUS] = ++orden;
+}
+static void iniciar_lector(void) {
+    iniciada_en[ETAPA_LECTOR] = ++orden;
+    reloj_us += 1000; // Reset y antena del RC522, bloqueantes
+}
+static void iniciar_teclado(void) {
+    iniciada_en[ETAPA_TECLADO] = ++orden;
+}
+static void iniciar_leds(void) {
+    iniciada_en[ETAPA_LEDS] = ++orden;
+}
+
+static const boot_stage etapas[CANTIDAD_ETAPAS] = {
+    [ETAPA_BUS] = {"bus", iniciar_bus, 0, false},
+    [ETAPA_LECTOR] = {"lector", iniciar_lector, BOOT_STAGE(ETAPA_BUS), false},
+    [ETAPA_TECLADO] = {"teclado", iniciar_teclado, 0, false},
+    [ETAPA_LEDS] = {"leds", iniciar_leds, 0, true},
+};
+
+static bool paso(uint32_t momento) {
+    reloj_us = momento;
+    return BOOT_Step();
+}
+
+static bool paso_diferido(uint32_t momento) {
+    reloj_us = momento;
+    return BOOT_StepDeferred();
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    orden = 0;
+    for (int i = 0; i < CANTIDAD_ETAPAS; i++) {
+        iniciada_en[i] = 0;
+    }
+    reloj_us = 100;
+    BOOT_Init(etapas, CANTIDAD_ETAPAS, reloj_falso);
+}
+
+void test_etapas_criticas_quedan_listas_en_una_pasada(void) {
+    TEST_ASSERT_TRUE(paso(100));
+    TEST_ASSERT_NOT_EQUAL(0, iniciada_en[ETAPA_BUS]);
+    TEST_ASSERT_NOT_EQUAL(0, iniciada_en[ETAPA_LECTOR]);
+    TEST_ASSERT_NOT_EQUAL(0, iniciada_en[ETAPA_TECLADO]);
+    TEST_ASSERT_GREATER_THAN(iniciada_en[ETAPA_BUS], iniciada_en[ETAPA_LECTOR]);
+}
+
+void test_dependencia_posterior_en_la_tabla_espera_otra_pasada(void) {
+    const boot_stage dependiente[] = {
+        {"lector", iniciar_lector, BOOT_STAGE(1), false},
+        {"bus", iniciar_bus, 0, false},
+    };
+    BOOT_Init(dependiente, 2, reloj_falso);
+
+    TEST_ASSERT_FALSE(paso(10));
+    TEST_ASSERT_EQUAL(0, iniciada_en[ETAPA_LECTOR]);
+    TEST_ASSERT_TRUE(paso(20));
+    TEST_ASSERT_GREATER_THAN(iniciada_en[ETAPA_BUS], iniciada_en[ETAPA_LECTOR]);
+}
+
+void test_linea_de_tiempo_registra_la_duracion_de_cada_etapa(void) {
+    TEST_ASSERT_TRUE(paso(100));
+
+    const boot_timeline_entry * linea = BOOT_GetTimeline();
+    TEST_ASSERT_EQUAL(0, linea[ETAPA_LECTOR].inicio_us);
+    TEST_ASSERT_EQUAL(1000, linea[ETAPA_LECTOR].lista_us);
+    TEST_ASSERT_EQUAL(1000, linea[ETAPA_TECLADO].inicio_us);
+}
+
+void test_etapas_diferidas_no_demoran_el_arranque(void) {
+    TEST_ASSERT_TRUE(paso(100));
+    TEST_ASSERT_EQUAL(0, iniciada_en[ETAPA_LEDS]);
+    TEST_ASSERT_TRUE(paso_diferido(2500));
+    TEST_ASSERT_NOT_EQUAL(0, iniciada_en[ETAPA_LEDS]);
+    TEST_ASSERT_EQUAL(2400, BOOT_GetTimeline()[ETAPA_LEDS].lista_us);
+}
+
+void test_etapa_omitida(void) {
+    BOOT_Skip(ETAPA_LECTOR);
+    TEST_ASSERT_TRUE(paso(100));
+    TEST_ASSERT_EQUAL(0, iniciada_en[ETAPA_LECTOR]);
+    TEST_ASSERT_TRUE(BOOT_GetTimeline()[ETAPA_LECTOR].omitida);
+}
@@ -0,0 +1,33 @@
+#include "unity.h"
+#include "BYTES.h"
+#include <string.h>
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+}
+
+void test_crc32_coincide_con_el_valor_de_control(void) {
+    const char * control = "123456789";
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926U, BYTES_Crc32((const uint8_t *)control, strlen(control)));
+    TEST_ASSERT_EQUAL_HEX32(0x00000000U, BYTES_Crc32(NULL, 0));
+}
+
+void test_campos_se_escriben_little_endian_y_encadenan(void) {
+    uint8_t campos[6];
+    uint8_t * p = BYTES_PutU16(campos, 0xBEEFU);
+    TEST_ASSERT_EQUAL_PTR(&campos[2], p);
+    p = BYTES_PutU32(p, 0x12345678U);
+    TEST_ASSERT_EQUAL_PTR(&campos[6], p);
+    const uint8_t esperado[6] = {0xEF, 0xBE, 0x78, 0x56, 0x34, 0x12};
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(esperado, campos, 6);
+}
+
+void test_lectura_invierte_la_escritura(void) {
+    uint8_t campos[6];
+    BYTES_PutU32(BYTES_PutU16(campos, 0x8001U), 0xF00000A5U);
+    TEST_ASSERT_EQUAL_UINT16(0x8001U, BYTES_GetU16(campos));
+    TEST_ASSERT_EQUAL_HEX32(0xF00000A5U, BYTES_GetU32(&campos[2]));
+}
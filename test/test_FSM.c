@@ -6,25 +6,37 @@
 #include "mock_TIMER.h"
 #include "mock_LED.h"
 #include "mock_SPI.h"
+#include "mock_ACCESS_RULES.h"
 #include "FSM.h"
+#include "TASKS.h"
+#include "METRICS.h"
+#include "LOCKOUT.h"
+#include "BYTES.h"
 
 #define TEST_NUMERO_PULSADO_DEFAULT 255U
 #define TEST_NUMERO_PULSADO_EN_USO  0
 
-STATE * TestState;
+const STATE * TestState;
 
 unsigned char test_id_tarjeta_valido[5] = "CARD";
 
+static uint32_t test_reloj(void) {
+    return 0;
+}
+
 /**
  * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
  *
  */
 void setUp(void) {
     TIMER_Start_CMockIgnore();
+    TIME_ResetTimeStatus_Ignore();
     LED_KeyboardPress_Ignore(); // Se ignora la funcion que prende los leds
     LED_Card_Blink_Ignore();    // Se ignora la funcion que parpadea leds cuando se lee una tarjeta
     LED_Wrong_Pin_Blink_Ignore(); // Se ignora la funcion que parpadea leds cuando se ingresa pin
                                   // incorrecto
+    TASKS_Init(test_reloj);
+    LOCKOUT_Init(test_reloj);
 }
 
 void test_inicializacion_FSM_puerta_cerrada(void) {
@@ -36,12 +48,30 @@ void test_validar_id_tarjeta_FSM(void) {
     unsigned char tarjeta_leida[5] = "CARD";
     GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
     USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, true);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false);
+    USERS_DATA_GET_CURRENT_USER_ID_ExpectAndReturn(0);
+    ACCESS_RULES_Check_ExpectAndReturn(0, true);
+    validar_id_tarjeta();
+}
+
+void test_tarjeta_valida_fuera_de_horario_FSM(void) {
+    unsigned char tarjeta_leida[5] = "CARD";
+    GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, true);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false);
+    USERS_DATA_GET_CURRENT_USER_ID_ExpectAndReturn(3);
+    ACCESS_RULES_Check_ExpectAndReturn(3, false); // El usuario no puede entrar a esta hora
+    test_set_NumeroPulsado(-1);
     validar_id_tarjeta();
+
+    get_RFID_event_ocurrence_IgnoreAndReturn(false);
+    TEST_ASSERT_EQUAL(TARJETA_INVALIDA, get_event());
 }
 void test_id_tarjeta_incorrecta_FSM(void) {
     unsigned char tarjeta_leida[5] = "ACME";
     GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
     USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, tarjeta_leida, false);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false);
     validar_id_tarjeta();
 }
 
@@ -50,6 +80,9 @@ void test_validar_avance_FSM_a_estado_validando_tarjeta(void) {
     unsigned char tarjeta_leida[5] = "CARD";
     GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
     USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, 1);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false);
+    USERS_DATA_GET_CURRENT_USER_ID_ExpectAndReturn(0);
+    ACCESS_RULES_Check_ExpectAndReturn(0, true);
     TestState =
         fsm(TestState,
             LECTURA_TARJETA); // La FSM avanza de estado y ejecuta fn USERS_DATA_VALIDATE_KEYCARD
@@ -270,8 +303,9 @@ void test_funcion_generador_evento_timer(void) {
     test_set_NumeroPulsado(-1);                      // No hay evento de numeros
     test_set_TarjetaValida(0);                       // No evento tarjeta
     test_set_pinValido(0);                           // El pin ingresado es incorrecto
-    TIME_GetTimeStatus_IgnoreAndReturn(true);        // Evento de timer
-    TIME_ResetTimeStatus_Ignore();
+    fsm_pendientes corriendo = {.NumeroPulsado = (uint8_t)-1, .timeout_activo = true};
+    FSM_RestorePending(&corriendo);           // TIMER_TIMEOUT en marcha
+    TIME_GetTimeStatus_IgnoreAndReturn(true); // Evento de timer
     eventos TestEvent = get_event();
     TEST_ASSERT_EQUAL(TIMEOUT_DEFAULT, TestEvent);
 }
@@ -285,3 +319,145 @@ void test_funcion_generador_evento_fin_tabla(void) {
     eventos TestEvent = get_event();
     TEST_ASSERT_EQUAL(FIN_TABLA, TestEvent);
 }
+
+void test_ids_de_estado(void) {
+    TEST_ASSERT_EQUAL(0, FSM_GetStateId(estado_puerta_cerrada));
+    TEST_ASSERT_EQUAL(7, FSM_GetStateId(estado_puerta_abierta));
+    TEST_ASSERT_EQUAL(FSM_CANTIDAD_ESTADOS, FSM_GetStateId(NULL));
+    TEST_ASSERT_EQUAL(estado_validando_pin, FSM_GetStateById(FSM_GetStateId(estado_validando_pin)));
+    TEST_ASSERT_NULL(FSM_GetStateById(FSM_CANTIDAD_ESTADOS));
+}
+
+void test_eventos_pendientes_se_retoman_con_el_timer(void) {
+    fsm_pendientes guardados = {.tarjetavalida = 0, .NumeroPulsado = 0, .pinValido = 1,
+                                .timeout_activo = true};
+    fsm_pendientes leidos;
+
+    FSM_RestorePending(&guardados); // Vuelve a iniciar TIMER_TIMEOUT (ignorado en setUp)
+    FSM_GetPending(&leidos);
+    TEST_ASSERT_EQUAL(1, leidos.pinValido);
+    TEST_ASSERT_TRUE(leidos.timeout_activo);
+
+    get_RFID_event_ocurrence_IgnoreAndReturn(false);
+    KEYBOARD_ReadData_IgnoreAndReturn(0);
+    TEST_ASSERT_EQUAL(PIN_VALIDO, get_event());
+}
+
+void test_validacion_espera_al_servidor_sin_bloquear_la_FSM(void) {
+    unsigned char tarjeta_leida[5] = "CARD";
+    GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, false);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(true); // Consulta al servidor en vuelo
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(true); // Primera vuelta de la espera
+    test_set_TarjetaValida(0);
+    test_set_pinValido(0);
+    TestState = fsm(estado_puerta_cerrada, LECTURA_TARJETA);
+    TEST_ASSERT_EQUAL(1, TASKS_Pending());
+
+    // Mientras tanto el lazo sigue entregando eventos
+    get_RFID_event_ocurrence_IgnoreAndReturn(false);
+    KEYBOARD_ReadData_IgnoreAndReturn(0);
+    TIME_GetTimeStatus_IgnoreAndReturn(false);
+    TEST_ASSERT_EQUAL(FIN_TABLA, get_event());
+
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(true);
+    TEST_ASSERT_EQUAL(1, TASKS_Run(1000));
+
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false); // Llego la respuesta
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, true);
+    USERS_DATA_GET_CURRENT_USER_ID_ExpectAndReturn(0);
+    ACCESS_RULES_Check_ExpectAndReturn(0, true);
+    TEST_ASSERT_EQUAL(0, TASKS_Run(1000));
+    TEST_ASSERT_EQUAL(TARJETA_VALIDA, get_event());
+}
+
+void test_timeout_durante_la_validacion_cancela_la_espera(void) {
+    unsigned char tarjeta_leida[5] = "CARD";
+    GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, false);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(true);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(true);
+    TestState = fsm(estado_puerta_cerrada, LECTURA_TARJETA);
+
+    TestState = fsm(TestState, TIMEOUT_DEFAULT); // El servidor no contesto a tiempo
+    TEST_ASSERT_EQUAL(estado_puerta_cerrada, TestState);
+    TEST_ASSERT_EQUAL(0, TASKS_Pending());
+    TEST_ASSERT_EQUAL(0, TASKS_Run(1000)); // Una respuesta tardia ya no valida la tarjeta
+}
+
+void test_tarjeta_bloqueada_se_rechaza_sin_consultar_al_servidor(void) {
+    unsigned char tarjeta_leida[5] = "CARD";
+    GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
+    for (int i = 0; i <= LOCKOUT_FREE_FAILURES; i++) {
+        LOCKOUT_RecordFailure(tarjeta_leida);
+    }
+    test_set_NumeroPulsado(-1);
+
+    TestState = fsm(estado_puerta_cerrada, LECTURA_TARJETA); // Sin llamadas a USERS_DATA
+    TEST_ASSERT_EQUAL(estado_validando_tarjeta, TestState);
+    get_RFID_event_ocurrence_IgnoreAndReturn(false);
+    TEST_ASSERT_EQUAL(TARJETA_INVALIDA, get_event());
+}
+
+void test_pin_incorrecto_repetido_corta_la_sesion(void) {
+    unsigned char tarjeta_leida[5] = "CARD";
+    uint8_t NumeroPulsado = 0;
+    GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, true);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false);
+    USERS_DATA_GET_CURRENT_USER_ID_ExpectAndReturn(0);
+    ACCESS_RULES_Check_ExpectAndReturn(0, true);
+    validar_id_tarjeta();
+    test_set_TarjetaValida(0);
+    for (int i = 0; i < LOCKOUT_FREE_FAILURES; i++) {
+        LOCKOUT_RecordFailure(tarjeta_leida); // Intentos anteriores de la misma tarjeta
+    }
+
+    USERS_DATA_COLLECT_FOURTH_NUMBER_CMockExpect(1, &NumeroPulsado);
+    USERS_DATA_VALIDATE_PIN_CMockExpectAndReturn(1, false);
+    TestState = fsm(estado_ingreso_cuarto_numero, LECTURA_NUMERO_TECLADO);
+    TEST_ASSERT_EQUAL(estado_validando_pin, TestState);
+
+    get_RFID_event_ocurrence_IgnoreAndReturn(false);
+    TestState = fsm(TestState, get_event()); // PIN_INVALIDO, el teclado queda deshabilitado
+    TEST_ASSERT_EQUAL(estado_ingreso_primer_numero, TestState);
+    TestState = fsm(TestState, get_event()); // La sesion termina sin esperar el timeout
+    TEST_ASSERT_EQUAL(estado_puerta_cerrada, TestState);
+
+    TIME_GetTimeStatus_IgnoreAndReturn(true); // Vence el timer que inicio el cuarto numero
+    TEST_ASSERT_EQUAL(FIN_TABLA, get_event());
+}
+
+void test_rechazo_del_servidor_no_deja_un_timeout_para_la_sesion_siguiente(void) {
+    unsigned char tarjeta_leida[5] = "CARD";
+    GetKeyRead_CMockIgnoreAndReturn(1, tarjeta_leida);
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, false);
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(true); // Inicia TIMER_TIMEOUT
+    USERS_DATA_KEYCARD_PENDING_ExpectAndReturn(false);
+    USERS_DATA_VALIDATE_KEYCARD_CMockExpectAndReturn(1, test_id_tarjeta_valido, false);
+    test_set_TarjetaValida(0);
+    test_set_pinValido(0);
+    TestState = fsm(estado_puerta_cerrada, LECTURA_TARJETA);
+
+    get_RFID_event_ocurrence_IgnoreAndReturn(false);
+    KEYBOARD_ReadData_IgnoreAndReturn(0);
+    TestState = fsm(TestState, get_event());
+    TEST_ASSERT_EQUAL(estado_puerta_cerrada, TestState);
+
+    TIME_GetTimeStatus_IgnoreAndReturn(true);
+    TEST_ASSERT_EQUAL(FIN_TABLA, get_event());
+}
+
+void test_eventos_ignorados_no_cuentan_como_transicion(void) {
+    uint8_t validando = FSM_GetStateId(estado_validando_tarjeta);
+    METRICS_Init(NULL);
+
+    TestState = fsm(estado_validando_tarjeta, LECTURA_TARJETA); // Cae en FIN_TABLA
+    TEST_ASSERT_EQUAL(estado_validando_tarjeta, TestState);
+    TEST_ASSERT_EQUAL(0, METRICS_GetCounter(METRIC_TRANSITION(validando)));
+    TEST_ASSERT_EQUAL(1, METRICS_GetCounter(METRIC_EVENT(LECTURA_TARJETA)));
+
+    TestState = fsm(TestState, TIMEOUT_DEFAULT);
+    TEST_ASSERT_EQUAL(estado_puerta_cerrada, TestState);
+    TEST_ASSERT_EQUAL(1, METRICS_GetCounter(METRIC_TRANSITION(validando)));
+}
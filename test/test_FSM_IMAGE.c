@@ -0,0 +1,197 @@
+#include "unity.h"
+#include "mock_RC522.h"
+#include "mock_TTP229.h"
+#include "mock_USERS_DATA.h"
+#include "mock_TIMER.h"
+#include "mock_LED.h"
+#include "mock_SPI.h"
+#include "mock_ACCESS_RULES.h"
+#include "FSM.h"
+#include "FSM_IMAGE.h"
+#include "TASKS.h"
+#include "METRICS.h"
+#include "LOCKOUT.h"
+#include "BYTES.h"
+#include <string.h>
+
+#define VERSION_SIMPLE 7
+
+/*Puerta simplificada: el PIN entero llega en un solo evento despues de la tarjeta*/
+static const uint8_t arcos_simple[][FSM_IMAGE_EDGE_LEN] = {
+    {TARJETA_VALIDA, 1, FSM_ACCION_NO_OPERATION}, // 0: cerrada
+    {FIN_TABLA, 0, FSM_ACCION_NO_OPERATION},
+    {PIN_VALIDO, 2, FSM_ACCION_ABRIR_PUERTA}, // 1: esperando el PIN
+    {TIMEOUT_DEFAULT, 0, FSM_ACCION_RESET_FSM},
+    {FIN_TABLA, 1, FSM_ACCION_NO_OPERATION},
+    {TIMEOUT_DEFAULT, 0, FSM_ACCION_CERRAR_PUERTA}, // 2: abierta
+    {FIN_TABLA, 2, FSM_ACCION_NO_OPERATION}};
+
+static uint8_t imagen[FSM_IMAGE_LEN(FSM_IMAGE_MAX_EDGES)];
+
+static uint32_t test_reloj(void) {
+    return 0;
+}
+
+static void sellar(uint16_t largo) {
+    uint32_t crc = BYTES_Crc32(imagen, largo - 4U);
+    for (int i = 0; i < 4; i++) {
+        imagen[largo - 4 + i] = (uint8_t)(crc >> (8 * i));
+    }
+}
+
+static uint16_t armar_imagen(const uint8_t (*arcos)[FSM_IMAGE_EDGE_LEN], uint16_t cantidad,
+                             uint8_t estados) {
+    uint16_t largo = FSM_IMAGE_LEN(cantidad);
+    memset(imagen, 0, sizeof(imagen));
+    memcpy(imagen, FSM_IMAGE_MAGIC, 4);
+    imagen[4] = FSM_IMAGE_FORMAT;
+    imagen[5] = estados;
+    imagen[6] = (uint8_t)cantidad;
+    imagen[8] = VERSION_SIMPLE;
+    memcpy(&imagen[FSM_IMAGE_HEADER_LEN], arcos, cantidad * FSM_IMAGE_EDGE_LEN);
+    sellar(largo);
+    return largo;
+}
+
+static uint16_t armar_simple(void) {
+    return armar_imagen(arcos_simple, sizeof(arcos_simple) / FSM_IMAGE_EDGE_LEN, 3);
+}
+
+/*Modifica un byte de un arco y vuelve a calcular el CRC, para probar la validacion de la tabla*/
+static uint16_t simple_con(uint8_t arco, uint8_t campo, uint8_t valor) {
+    uint16_t largo = armar_simple();
+    imagen[FSM_IMAGE_HEADER_LEN + arco * FSM_IMAGE_EDGE_LEN + campo] = valor;
+    sellar(largo);
+    return largo;
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    TIMER_Start_CMockIgnore();
+    TIME_ResetTimeStatus_Ignore();
+    LED_OPEN_DOOR_Ignore();
+    TASKS_Init(test_reloj);
+    FSM_IMAGE_LoadBuiltin();
+    FSM_IMAGE_Apply(FSM_GetInitState());
+}
+
+void test_tablas_compiladas_exportadas_se_recargan_iguales(void) {
+    uint16_t largo = FSM_IMAGE_Export(imagen, sizeof(imagen));
+
+    TEST_ASSERT_EQUAL(FSM_IMAGE_OK, FSM_IMAGE_Load(imagen, largo));
+    const STATE * estado = FSM_IMAGE_Apply(FSM_GetInitState());
+    TEST_ASSERT_NOT_EQUAL(estado_puerta_cerrada, estado); // Ahora son las tablas de la imagen
+    TEST_ASSERT_EQUAL(FSM_TABLE_VERSION, FSM_GetTables()->version);
+    TEST_ASSERT_EQUAL(FSM_CANTIDAD_ESTADOS, FSM_GetTables()->cantidad);
+
+    estado = fsm(FSM_GetStateById(2), LECTURA_TARJETA); // Evento sin arco en ese estado
+    TEST_ASSERT_EQUAL(2, FSM_GetStateId(estado));
+    estado = fsm(FSM_GetStateById(7), TIMEOUT_DEFAULT);
+    TEST_ASSERT_EQUAL(0, FSM_GetStateId(estado));
+
+    uint8_t otra[sizeof(imagen)];
+    TEST_ASSERT_EQUAL(largo, FSM_IMAGE_Export(otra, sizeof(otra)));
+    TEST_ASSERT_EQUAL_MEMORY(imagen, otra, largo);
+}
+
+void test_imagen_con_otras_tablas(void) {
+    TEST_ASSERT_EQUAL(FSM_IMAGE_OK, FSM_IMAGE_Load(imagen, armar_simple()));
+    const STATE * estado = FSM_IMAGE_Apply(FSM_GetInitState());
+    TEST_ASSERT_EQUAL(VERSION_SIMPLE, FSM_GetTables()->version);
+
+    estado = fsm(estado, TARJETA_VALIDA);
+    estado = fsm(estado, PIN_VALIDO);
+    TEST_ASSERT_EQUAL(2, FSM_GetStateId(estado));
+    estado = fsm(estado, TIMEOUT_DEFAULT);
+    TEST_ASSERT_EQUAL_PTR(FSM_GetInitState(), estado);
+}
+
+void test_imagen_corrupta_se_rechaza(void) {
+    uint16_t largo = armar_simple();
+
+    imagen[FSM_IMAGE_HEADER_LEN] ^= 0x01;
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_CRC, FSM_IMAGE_Load(imagen, largo));
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_LARGO, FSM_IMAGE_Load(imagen, largo - 1));
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_LARGO, FSM_IMAGE_Load(NULL, 0));
+
+    largo = armar_simple();
+    imagen[4] = FSM_IMAGE_FORMAT + 1;
+    sellar(largo);
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_FORMATO, FSM_IMAGE_Load(imagen, largo));
+    TEST_ASSERT_FALSE(FSM_IMAGE_Pending());
+}
+
+void test_arcos_invalidos_se_rechazan(void) {
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_EVENTO, FSM_IMAGE_Validate(imagen, simple_con(0, 0, 0x20)));
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_EVENTO,
+                      FSM_IMAGE_Validate(imagen, simple_con(3, 0, PIN_VALIDO))); // Repetido
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_ESTADO, FSM_IMAGE_Validate(imagen, simple_con(0, 1, 3)));
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_ACCION,
+                      FSM_IMAGE_Validate(imagen, simple_con(0, 2, FSM_ACCIONES)));
+}
+
+void test_estados_mal_terminados_se_rechazan(void) {
+    // El arco FIN_TABLA de la espera del PIN abriria la puerta con cualquier evento
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_TABLA, FSM_IMAGE_Validate(imagen, simple_con(4, 1, 2)));
+    // Se declaran mas estados que los que terminan en FIN_TABLA
+    uint16_t largo = armar_imagen(arcos_simple, sizeof(arcos_simple) / FSM_IMAGE_EDGE_LEN, 4);
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_TABLA, FSM_IMAGE_Validate(imagen, largo));
+    // Arcos sueltos despues del ultimo estado
+    const uint8_t sobrantes[][FSM_IMAGE_EDGE_LEN] = {{FIN_TABLA, 0, FSM_ACCION_NO_OPERATION},
+                                                     {TIMEOUT_DEFAULT, 0, FSM_ACCION_RESET_FSM}};
+    largo = armar_imagen(sobrantes, 2, 1);
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_TABLA, FSM_IMAGE_Validate(imagen, largo));
+}
+
+void test_el_cambio_espera_a_que_la_maquina_vuelva_al_reposo(void) {
+    const STATE * estado = estado_validando_pin;
+
+    FSM_IMAGE_Load(imagen, armar_simple());
+    estado = FSM_IMAGE_Apply(estado);
+    TEST_ASSERT_EQUAL_PTR(estado_validando_pin, estado);
+    TEST_ASSERT_TRUE(FSM_IMAGE_Pending());
+
+    estado = fsm(estado, TIMEOUT_DEFAULT); // La sesion termina con las tablas compiladas
+    TEST_ASSERT_EQUAL_PTR(estado_puerta_cerrada, estado);
+    estado = FSM_IMAGE_Apply(estado);
+    TEST_ASSERT_FALSE(FSM_IMAGE_Pending());
+    TEST_ASSERT_EQUAL(3, FSM_GetTables()->cantidad);
+    TEST_ASSERT_EQUAL_PTR(FSM_GetInitState(), estado);
+}
+
+void test_cargar_otra_imagen_no_toca_la_tabla_activa(void) {
+    FSM_IMAGE_Load(imagen, armar_simple());
+    const STATE * sesion = fsm(FSM_IMAGE_Apply(FSM_GetInitState()), TARJETA_VALIDA);
+
+    TEST_ASSERT_EQUAL(FSM_IMAGE_OK, FSM_IMAGE_Load(imagen, armar_simple())); // Al otro banco
+
+    TEST_ASSERT_EQUAL(2, FSM_GetStateId(fsm(sesion, PIN_VALIDO)));
+    TEST_ASSERT_EQUAL_PTR(sesion, FSM_IMAGE_Apply(sesion));
+}
+
+void test_puerta_abierta_fuera_del_pin_se_rechaza(void) {
+    // Abrir con la tarjeta sola
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_PUERTA,
+                      FSM_IMAGE_Validate(imagen, simple_con(0, 2, FSM_ACCION_ABRIR_PUERTA)));
+    // Salir de la puerta abierta sin cerrarla
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_PUERTA,
+                      FSM_IMAGE_Validate(imagen, simple_con(5, 2, FSM_ACCION_RESET_FSM)));
+    // Dejarla abierta en el estado inicial, donde se cambian las tablas
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_PUERTA, FSM_IMAGE_Validate(imagen, simple_con(2, 1, 0)));
+    // Una puerta abierta sin ninguna salida
+    TEST_ASSERT_EQUAL(FSM_IMAGE_ERR_PUERTA, FSM_IMAGE_Validate(imagen, simple_con(5, 1, 2)));
+    TEST_ASSERT_FALSE(FSM_IMAGE_Pending());
+}
+
+void test_volver_a_las_tablas_compiladas(void) {
+    FSM_IMAGE_Load(imagen, armar_simple());
+    FSM_IMAGE_Apply(FSM_GetInitState());
+
+    FSM_IMAGE_LoadBuiltin();
+    TEST_ASSERT_EQUAL_PTR(estado_puerta_cerrada, FSM_IMAGE_Apply(FSM_GetInitState()));
+    TEST_ASSERT_EQUAL(FSM_TABLE_VERSION, FSM_GetTables()->version);
+    TEST_ASSERT_EQUAL(1, FSM_GetStateId(estado_validando_tarjeta));
+}
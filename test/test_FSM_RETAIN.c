@@ -0,0 +1,121 @@
+#include "unity.h"
+#include "FSM_RETAIN.h"
+#include "BYTES.h"
+#include <string.h>
+
+#define ESTADO_INGRESO_SEGUNDO_NUMERO 3
+
+static uint8_t ram_retenida[256];
+static fsm_pendientes sesion = {.tarjetavalida = 0, .NumeroPulsado = 7, .pinValido = -1,
+                                .timeout_activo = true};
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    memset(ram_retenida, 0xA5, sizeof(ram_retenida)); // Basura de un arranque en frio
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_POWER_ON);
+}
+
+void test_arranque_en_frio_no_tiene_sesion(void) {
+    uint8_t estado;
+    fsm_pendientes pendientes;
+    TEST_ASSERT_FALSE(FSM_RETAIN_Restore(&estado, &pendientes));
+    TEST_ASSERT_FALSE(FSM_RETAIN_GetPeripheralsReady());
+    TEST_ASSERT_EQUAL(0, FSM_RETAIN_GetStats()->arranques_frios);
+}
+
+void test_sesion_guardada_se_retoma_despues_del_reset(void) {
+    uint8_t estado;
+    fsm_pendientes pendientes;
+
+    FSM_RETAIN_Save(ESTADO_INGRESO_SEGUNDO_NUMERO, &sesion);
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_WATCHDOG); // La RAM retenida conserva su contenido
+
+    TEST_ASSERT_TRUE(FSM_RETAIN_Restore(&estado, &pendientes));
+    TEST_ASSERT_EQUAL(ESTADO_INGRESO_SEGUNDO_NUMERO, estado);
+    TEST_ASSERT_EQUAL(7, pendientes.NumeroPulsado);
+    TEST_ASSERT_EQUAL(-1, pendientes.pinValido);
+    TEST_ASSERT_TRUE(pendientes.timeout_activo);
+}
+
+void test_sesion_corrupta_fuerza_arranque_en_frio(void) {
+    uint8_t estado;
+    fsm_pendientes pendientes;
+
+    FSM_RETAIN_Save(ESTADO_INGRESO_SEGUNDO_NUMERO, &sesion);
+    ram_retenida[8] ^= 0x01;
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_WATCHDOG);
+    TEST_ASSERT_FALSE(FSM_RETAIN_Restore(&estado, &pendientes));
+}
+
+void test_estado_desconocido_no_se_guarda(void) {
+    uint8_t estado;
+    fsm_pendientes pendientes;
+    FSM_RETAIN_Save(FSM_CANTIDAD_ESTADOS, &sesion);
+    TEST_ASSERT_FALSE(FSM_RETAIN_Restore(&estado, &pendientes));
+}
+
+void test_invalidar_sesion(void) {
+    uint8_t estado;
+    fsm_pendientes pendientes;
+    FSM_RETAIN_Save(ESTADO_INGRESO_SEGUNDO_NUMERO, &sesion);
+    FSM_RETAIN_Invalidate();
+    TEST_ASSERT_FALSE(FSM_RETAIN_Restore(&estado, &pendientes));
+}
+
+void test_perifericos_listos_sobreviven_al_reset(void) {
+    FSM_RETAIN_Save(0, &sesion);
+    FSM_RETAIN_SetPeripheralsReady(true);
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_WATCHDOG);
+    TEST_ASSERT_TRUE(FSM_RETAIN_GetPeripheralsReady());
+}
+
+void test_solo_watchdog_o_software_retoman_la_sesion(void) {
+    const fsm_reset_cause causas[] = {FSM_RESET_POWER_ON, FSM_RESET_BROWNOUT, FSM_RESET_PIN};
+    uint8_t estado;
+    fsm_pendientes pendientes;
+
+    for (uint8_t i = 0; i < sizeof(causas) / sizeof(causas[0]); i++) {
+        FSM_RETAIN_Save(ESTADO_INGRESO_SEGUNDO_NUMERO, &sesion);
+        FSM_RETAIN_SetPeripheralsReady(true);
+        FSM_RETAIN_Init(ram_retenida, causas[i]);
+        TEST_ASSERT_FALSE(FSM_RETAIN_Restore(&estado, &pendientes));
+        TEST_ASSERT_FALSE(FSM_RETAIN_GetPeripheralsReady()); // El RC522 pudo perder alimentacion
+    }
+
+    FSM_RETAIN_Save(ESTADO_INGRESO_SEGUNDO_NUMERO, &sesion);
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_SOFTWARE);
+    TEST_ASSERT_TRUE(FSM_RETAIN_Restore(&estado, &pendientes));
+}
+
+void test_tiempos_de_arranque_frio_y_caliente(void) {
+    FSM_RETAIN_RecordBoot(false, 5000);
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_WATCHDOG);
+    FSM_RETAIN_RecordBoot(true, 300);
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_WATCHDOG);
+
+    const fsm_retain_stats * stats = FSM_RETAIN_GetStats();
+    TEST_ASSERT_EQUAL(1, stats->arranques_frios);
+    TEST_ASSERT_EQUAL(1, stats->arranques_calientes);
+    TEST_ASSERT_EQUAL(5000, stats->ultimo_frio_us);
+    TEST_ASSERT_EQUAL(300, stats->ultimo_caliente_us);
+}
+
+void test_estadisticas_sobreviven_al_arranque_en_frio(void) {
+    FSM_RETAIN_Save(ESTADO_INGRESO_SEGUNDO_NUMERO, &sesion);
+    FSM_RETAIN_RecordBoot(false, 5000);
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_BROWNOUT); // Descarta la sesion
+    FSM_RETAIN_RecordBoot(false, 4000);
+
+    TEST_ASSERT_EQUAL(2, FSM_RETAIN_GetStats()->arranques_frios);
+    TEST_ASSERT_EQUAL(4000, FSM_RETAIN_GetStats()->ultimo_frio_us);
+}
+
+void test_estadisticas_corruptas_vuelven_a_cero(void) {
+    FSM_RETAIN_RecordBoot(false, 5000);
+    ram_retenida[24] ^= 0x01; // Contadores, despues de los 16 bytes de la sesion
+    FSM_RETAIN_Init(ram_retenida, FSM_RESET_WATCHDOG);
+    TEST_ASSERT_EQUAL(0, FSM_RETAIN_GetStats()->arranques_frios);
+}
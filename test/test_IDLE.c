@@ -0,0 +1,85 @@
+#include "unity.h"
+#include "IDLE.h"
+#include <time.h>
+
+/*Reloj guionado: cada lectura devuelve el siguiente valor de la lista*/
+static uint32_t lecturas[8];
+static int proxima_lectura;
+static bool timeout_vencido;
+
+static uint32_t reloj_falso(void) {
+    uint32_t valor = lecturas[proxima_lectura];
+    if (proxima_lectura < 7) {
+        proxima_lectura++;
+    }
+    return valor;
+}
+
+static bool timer_vencido(void) {
+    return timeout_vencido;
+}
+
+static void programar_reloj(uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    lecturas[0] = a;
+    lecturas[1] = b;
+    lecturas[2] = c;
+    for (int i = 3; i < 8; i++) {
+        lecturas[i] = d;
+    }
+    proxima_lectura = 0;
+}
+
+static uint32_t microsegundos_reales(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000U + ts.tv_nsec / 1000U);
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    timeout_vencido = false;
+    programar_reloj(0, 0, 0, 0);
+    IDLE_Init(reloj_falso, timer_vencido);
+}
+
+void test_no_duerme_si_el_timeout_ya_vencio(void) {
+    timeout_vencido = true;
+    TEST_ASSERT_FALSE(IDLE_Sleep());
+    TEST_ASSERT_EQUAL(0, IDLE_GetStats()->despertares);
+}
+
+void test_el_reposo_no_pasa_de_la_encuesta(void) {
+    IDLE_Init(microsegundos_reales, timer_vencido);
+
+    uint32_t inicio = microsegundos_reales();
+    TEST_ASSERT_TRUE(IDLE_Sleep());
+    uint32_t dormido = microsegundos_reales() - inicio;
+
+    TEST_ASSERT_GREATER_OR_EQUAL(IDLE_MAX_SLEEP_US * 9 / 10, dormido);
+    TEST_ASSERT_LESS_THAN(IDLE_MAX_SLEEP_US * 3, dormido);
+}
+
+void test_ciclo_util_y_despertares_por_segundo(void) {
+    // Despierto el primer cuarto de la ventana y dormido el resto
+    uint32_t despierto = IDLE_STATS_WINDOW_US / 4;
+    programar_reloj(despierto, despierto + IDLE_MAX_SLEEP_US - 10, IDLE_STATS_WINDOW_US,
+                    IDLE_STATS_WINDOW_US);
+    TEST_ASSERT_TRUE(IDLE_Sleep());
+
+    const idle_stats * stats = IDLE_GetStats();
+    TEST_ASSERT_EQUAL(1, stats->ventanas);
+    TEST_ASSERT_EQUAL(1, stats->despertares);
+    TEST_ASSERT_EQUAL(250, stats->ciclo_util_permil);
+    TEST_ASSERT_EQUAL(1, stats->despertares_por_seg);
+}
+
+void test_la_ventana_no_cierra_antes_de_tiempo(void) {
+    programar_reloj(1000, 1000 + IDLE_MAX_SLEEP_US - 10, 1000 + IDLE_MAX_SLEEP_US,
+                    1000 + IDLE_MAX_SLEEP_US);
+    TEST_ASSERT_TRUE(IDLE_Sleep());
+    TEST_ASSERT_EQUAL(0, IDLE_GetStats()->ventanas);
+    TEST_ASSERT_EQUAL(1, IDLE_GetStats()->despertares);
+}
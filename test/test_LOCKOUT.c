@@ -0,0 +1,149 @@
+#include "unity.h"
+#include "LOCKOUT.h"
+#include "METRICS.h"
+#include "BYTES.h"
+
+static uint32_t reloj_ms;
+
+static const uint8_t tarjeta_a[4] = {0x93, 0x2A, 0x4C, 0x1B};
+static const uint8_t tarjeta_b[4] = {0x11, 0x22, 0x33, 0x44};
+
+static uint32_t reloj_falso(void) {
+    return reloj_ms;
+}
+
+static void fallar(const uint8_t * uid, int veces) {
+    for (int i = 0; i < veces; i++) {
+        LOCKOUT_RecordFailure(uid);
+    }
+}
+
+/*Tarjetas distintas para llenar la tabla, ninguna llega a bloquearse sola*/
+static void tarjeta_numero(uint8_t * uid, uint32_t numero) {
+    uid[0] = (uint8_t)numero;
+    uid[1] = (uint8_t)(numero >> 8);
+    uid[2] = 0xC0;
+    uid[3] = 0xDE;
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    reloj_ms = 1000;
+    METRICS_Init(NULL);
+    LOCKOUT_Init(reloj_falso);
+}
+
+void test_tarjeta_sin_fallos_puede_ingresar_el_pin(void) {
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_a));
+    TEST_ASSERT_EQUAL(0, LOCKOUT_RemainingMs(tarjeta_a));
+}
+
+void test_los_primeros_fallos_no_bloquean(void) {
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES);
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_a));
+
+    TEST_ASSERT_TRUE(LOCKOUT_RecordFailure(tarjeta_a));
+    TEST_ASSERT_FALSE(LOCKOUT_Allowed(tarjeta_a));
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_b)); // Las demas tarjetas siguen entrando
+    TEST_ASSERT_EQUAL(LOCKOUT_BASE_MS, LOCKOUT_RemainingMs(tarjeta_a));
+    TEST_ASSERT_EQUAL(1, LOCKOUT_GetStats()->rechazos);
+    TEST_ASSERT_EQUAL(1, METRICS_GetCounter(METRIC_LOCKOUT_REJECTS));
+
+    reloj_ms += LOCKOUT_BASE_MS;
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_a));
+}
+
+void test_cada_fallo_bloqueado_duplica_la_espera_hasta_el_tope(void) {
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES + 1);
+    reloj_ms += LOCKOUT_BASE_MS;
+    LOCKOUT_RecordFailure(tarjeta_a);
+    TEST_ASSERT_EQUAL(2 * LOCKOUT_BASE_MS, LOCKOUT_RemainingMs(tarjeta_a));
+    reloj_ms += 2 * LOCKOUT_BASE_MS;
+    LOCKOUT_RecordFailure(tarjeta_a);
+    TEST_ASSERT_EQUAL(4 * LOCKOUT_BASE_MS, LOCKOUT_RemainingMs(tarjeta_a));
+
+    for (int i = 0; i < 10; i++) {
+        reloj_ms += LOCKOUT_RemainingMs(tarjeta_a);
+        LOCKOUT_RecordFailure(tarjeta_a);
+    }
+    TEST_ASSERT_EQUAL(LOCKOUT_MAX_MS, LOCKOUT_RemainingMs(tarjeta_a));
+}
+
+void test_pin_correcto_reinicia_el_contador_de_la_tarjeta(void) {
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES);
+    LOCKOUT_RecordSuccess(tarjeta_a);
+
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES);
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_a));
+}
+
+void test_pin_correcto_no_reinicia_el_contador_de_la_puerta(void) {
+    uint8_t uid[4];
+
+    for (uint32_t i = 0; i < LOCKOUT_DOOR_FREE_FAILURES; i++) {
+        tarjeta_numero(uid, i);
+        fallar(uid, 1);
+        LOCKOUT_RecordSuccess(uid);
+    }
+    TEST_ASSERT_TRUE(LOCKOUT_RecordFailure(tarjeta_b)); // Los fallos anteriores siguen contando
+    TEST_ASSERT_FALSE(LOCKOUT_Allowed(tarjeta_a));
+
+    reloj_ms += LOCKOUT_FORGET_MS; // Solo el tiempo los olvida
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_a));
+    TEST_ASSERT_FALSE(LOCKOUT_RecordFailure(tarjeta_b));
+}
+
+void test_fallos_viejos_se_olvidan(void) {
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES);
+    reloj_ms += LOCKOUT_FORGET_MS;
+
+    TEST_ASSERT_FALSE(LOCKOUT_RecordFailure(tarjeta_a));
+    TEST_ASSERT_TRUE(LOCKOUT_Allowed(tarjeta_a));
+}
+
+void test_el_reloj_que_da_la_vuelta_no_cambia_la_espera(void) {
+    reloj_ms = 0xFFFFFFFFU - 1000U;
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES + 1);
+
+    reloj_ms += 2000; // Ya dio la vuelta
+    TEST_ASSERT_EQUAL(LOCKOUT_BASE_MS - 2000, LOCKOUT_RemainingMs(tarjeta_a));
+}
+
+void test_muchas_tarjetas_bloquean_la_puerta(void) {
+    uint8_t uid[4];
+
+    for (uint32_t i = 0; i < LOCKOUT_DOOR_FREE_FAILURES; i++) {
+        tarjeta_numero(uid, i);
+        TEST_ASSERT_FALSE(LOCKOUT_RecordFailure(uid));
+    }
+    tarjeta_numero(uid, LOCKOUT_DOOR_FREE_FAILURES);
+    TEST_ASSERT_TRUE(LOCKOUT_RecordFailure(uid));
+
+    TEST_ASSERT_FALSE(LOCKOUT_Allowed(tarjeta_b)); // Ni siquiera una tarjeta sin fallos
+    TEST_ASSERT_EQUAL(LOCKOUT_DOOR_BASE_MS, LOCKOUT_RemainingMs(tarjeta_b));
+}
+
+void test_se_desaloja_la_tarjeta_usada_hace_mas_tiempo(void) {
+    uint8_t uid[4];
+
+    fallar(tarjeta_a, LOCKOUT_FREE_FAILURES + 1); // La primera en entrar a la tabla
+    fallar(tarjeta_b, 1);
+    for (uint32_t i = 0; i < LOCKOUT_MAX_CARDS - 2; i++) {
+        tarjeta_numero(uid, i);
+        fallar(uid, 1);
+    }
+    fallar(tarjeta_a, 1); // Vuelve a ser la mas reciente, ahora la menos reciente es b
+    TEST_ASSERT_EQUAL(0, LOCKOUT_GetStats()->desalojos);
+
+    // Con tantos fallos la puerta queda bloqueada: se mira la tabla por los desalojos
+    tarjeta_numero(uid, 1000);
+    fallar(uid, 1);
+    TEST_ASSERT_EQUAL(1, LOCKOUT_GetStats()->desalojos);
+    fallar(tarjeta_a, 1); // Sigue en la tabla, no desaloja a nadie
+    TEST_ASSERT_EQUAL(1, LOCKOUT_GetStats()->desalojos);
+    fallar(tarjeta_b, 1); // Se habia desalojado: vuelve a entrar en el lugar de otra
+    TEST_ASSERT_EQUAL(2, LOCKOUT_GetStats()->desalojos);
+}
@@ -0,0 +1,116 @@
+#include "unity.h"
+#include "METRICS.h"
+#include "BYTES.h"
+#include <string.h>
+
+static bool colector_pidio;
+static int tramas_enviadas;
+static uint8_t ultima_trama[METRICS_FRAME_LEN];
+static uint16_t largo_ultima_trama;
+
+static bool fake_pedido(void) {
+    bool pedido = colector_pidio;
+    colector_pidio = false;
+    return pedido;
+}
+
+static void fake_enviar(const uint8_t * trama, uint16_t largo) {
+    tramas_enviadas++;
+    memcpy(ultima_trama, trama, largo);
+    largo_ultima_trama = largo;
+}
+
+static const metrics_sink socket_falso = {fake_pedido, fake_enviar};
+static const metrics_sink uart_falsa = {NULL, fake_enviar};
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    colector_pidio = false;
+    tramas_enviadas = 0;
+    largo_ultima_trama = 0;
+    METRICS_Init(&socket_falso);
+}
+
+void test_contadores_por_estado_y_por_evento(void) {
+    METRICS_Inc(METRIC_TRANSITION(3));
+    METRICS_Inc(METRIC_TRANSITION(3));
+    METRICS_Inc(METRIC_EVENT(PIN_INVALIDO));
+    METRICS_Add(METRIC_LOCKOUT_REJECTS, 5);
+
+    TEST_ASSERT_EQUAL(2, METRICS_GetCounter(METRIC_TRANSITION(3)));
+    TEST_ASSERT_EQUAL(0, METRICS_GetCounter(METRIC_TRANSITION(4)));
+    TEST_ASSERT_EQUAL(1, METRICS_GetCounter(METRIC_EVENT(PIN_INVALIDO)));
+    TEST_ASSERT_EQUAL(5, METRICS_GetCounter(METRIC_LOCKOUT_REJECTS));
+}
+
+void test_cubetas_de_potencias_de_dos(void) {
+    METRICS_Observe(METRIC_HIST_LOOP_US, 0);
+    METRICS_Observe(METRIC_HIST_LOOP_US, 1);
+    METRICS_Observe(METRIC_HIST_LOOP_US, 2);
+    METRICS_Observe(METRIC_HIST_LOOP_US, 3);
+    METRICS_Observe(METRIC_HIST_LOOP_US, 1000);     // [512, 1024)
+    METRICS_Observe(METRIC_HIST_LOOP_US, 0xFFFFFFFF); // Se satura en la ultima
+
+    TEST_ASSERT_EQUAL(1, METRICS_GetBucket(METRIC_HIST_LOOP_US, 0));
+    TEST_ASSERT_EQUAL(1, METRICS_GetBucket(METRIC_HIST_LOOP_US, 1));
+    TEST_ASSERT_EQUAL(2, METRICS_GetBucket(METRIC_HIST_LOOP_US, 2));
+    TEST_ASSERT_EQUAL(1, METRICS_GetBucket(METRIC_HIST_LOOP_US, 10));
+    TEST_ASSERT_EQUAL(1, METRICS_GetBucket(METRIC_HIST_LOOP_US, METRICS_BUCKETS - 1));
+    TEST_ASSERT_EQUAL(0, METRICS_GetBucket(METRIC_HIST_CARD_READ_US, 10));
+}
+
+void test_formato_de_la_trama(void) {
+    uint8_t trama[METRICS_FRAME_LEN];
+
+    METRICS_Inc(METRIC_LOOP_ITERATIONS);
+    METRICS_Observe(METRIC_HIST_CARD_READ_US, 25);
+
+    TEST_ASSERT_EQUAL(0, METRICS_BuildFrame(trama, sizeof(trama) - 1, 0));
+    TEST_ASSERT_EQUAL(METRICS_FRAME_LEN, METRICS_BuildFrame(trama, sizeof(trama), 1234));
+    TEST_ASSERT_EQUAL_MEMORY(METRICS_FRAME_MAGIC, trama, 4);
+    TEST_ASSERT_EQUAL(METRICS_FRAME_VERSION, trama[4]);
+    TEST_ASSERT_EQUAL(METRICS_COUNTERS, trama[5]);
+    TEST_ASSERT_EQUAL(1234, BYTES_GetU32(&trama[12]));
+
+    const uint8_t * contadores = &trama[METRICS_HEADER_LEN];
+    TEST_ASSERT_EQUAL(1, BYTES_GetU32(&contadores[4 * METRIC_LOOP_ITERATIONS]));
+    const uint8_t * cubetas = &contadores[4 * METRICS_COUNTERS];
+    const uint8_t * lecturas = &cubetas[4 * METRIC_HIST_CARD_READ_US * METRICS_BUCKETS];
+    TEST_ASSERT_EQUAL(1, BYTES_GetU32(&lecturas[4 * 5])); // 25 cae en [16, 32)
+
+    TEST_ASSERT_EQUAL_HEX32(BYTES_Crc32(trama, METRICS_FRAME_LEN - 4),
+                            BYTES_GetU32(&trama[METRICS_FRAME_LEN - 4]));
+}
+
+void test_la_secuencia_avanza_en_cada_trama(void) {
+    uint8_t trama[METRICS_FRAME_LEN];
+
+    METRICS_BuildFrame(trama, sizeof(trama), 0);
+    TEST_ASSERT_EQUAL(0, BYTES_GetU32(&trama[8]));
+    METRICS_BuildFrame(trama, sizeof(trama), 0);
+    TEST_ASSERT_EQUAL(1, BYTES_GetU32(&trama[8]));
+}
+
+void test_socket_responde_solo_cuando_el_colector_pide(void) {
+    METRICS_Service(0);
+    TEST_ASSERT_EQUAL(0, tramas_enviadas);
+
+    colector_pidio = true;
+    METRICS_Service(10);
+    TEST_ASSERT_EQUAL(1, tramas_enviadas);
+    TEST_ASSERT_EQUAL(METRICS_FRAME_LEN, largo_ultima_trama);
+}
+
+void test_uart_envia_periodicamente(void) {
+    METRICS_Init(&uart_falsa);
+    METRICS_Service(METRICS_EXPORT_PERIOD_MS - 1);
+    TEST_ASSERT_EQUAL(0, tramas_enviadas);
+    METRICS_Service(METRICS_EXPORT_PERIOD_MS);
+    METRICS_Service(METRICS_EXPORT_PERIOD_MS + 1);
+    TEST_ASSERT_EQUAL(1, tramas_enviadas);
+    METRICS_Service(2 * METRICS_EXPORT_PERIOD_MS);
+    TEST_ASSERT_EQUAL(2, tramas_enviadas);
+}
@@ -0,0 +1,237 @@
+#include "unity.h"
+#include "MIFARE.h"
+#include "METRICS.h"
+#include "BYTES.h"
+#include <string.h>
+
+#define SECTOR_CREDENCIAL 2
+#define CARD_IDLE         0
+#define CARD_READY        1
+#define CARD_ACTIVE       2
+
+/*Tarjeta MIFARE Classic virtual del otro lado del lector*/
+static struct {
+    bool en_campo;
+    int estado;
+    int sector_autenticado;
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t clave[MIFARE_KEY_LEN];
+    uint8_t bloques[MIFARE_SECTORS * MIFARE_BLOCKS_PER_SECT][MIFARE_BLOCK_SIZE];
+} tarjeta;
+
+static int tramas;
+static bool bcc_corrupto;
+static int autenticaciones;
+static bool lector_liberado;
+static bool cifrado; // Crypto1 encendido en el lector
+static uint32_t reloj_us;
+
+static const uint8_t clave_a[MIFARE_KEY_LEN] = {0xA0, 0xA1, 0xA2, 0xA3, 0xA4, 0xA5};
+
+static uint32_t reloj_falso(void) {
+    return reloj_us;
+}
+
+static mifare_status fake_transceive(const uint8_t * tx, uint8_t tx_len, uint8_t bits_finales,
+                                     bool crc, uint8_t * rx, uint8_t * rx_len) {
+    (void)tx_len;
+    (void)crc;
+    tramas++;
+    lector_liberado = false;
+    reloj_us += 1000; // Cada intercambio por RF tarda del orden de un milisegundo
+
+    if (!tarjeta.en_campo) {
+        return MIFARE_NO_TAG;
+    }
+    if (tx[0] == 0x26 && bits_finales == 7) {
+        if (tarjeta.estado != CARD_IDLE) {
+            return MIFARE_NO_TAG;
+        }
+        tarjeta.estado = CARD_READY;
+        rx[0] = 0x04;
+        rx[1] = 0x00;
+        *rx_len = 2;
+        return MIFARE_OK;
+    }
+    if (tx[0] == 0x93 && tx[1] == 0x20 && tarjeta.estado == CARD_READY) {
+        memcpy(rx, tarjeta.uid, MIFARE_UID_LEN);
+        rx[4] = tarjeta.uid[0] ^ tarjeta.uid[1] ^ tarjeta.uid[2] ^ tarjeta.uid[3];
+        rx[4] ^= bcc_corrupto ? 0x01 : 0x00;
+        *rx_len = 5;
+        return MIFARE_OK;
+    }
+    if (tx[0] == 0x93 && tx[1] == 0x70 && tarjeta.estado == CARD_READY &&
+        memcmp(&tx[2], tarjeta.uid, MIFARE_UID_LEN) == 0) {
+        tarjeta.estado = CARD_ACTIVE;
+        rx[0] = 0x08; // SAK de MIFARE Classic 1K
+        *rx_len = 1;
+        return MIFARE_OK;
+    }
+    if (tx[0] == 0x30 && tarjeta.estado == CARD_ACTIVE &&
+        tarjeta.sector_autenticado == tx[1] / MIFARE_BLOCKS_PER_SECT) {
+        memcpy(rx, tarjeta.bloques[tx[1]], MIFARE_BLOCK_SIZE);
+        *rx_len = MIFARE_BLOCK_SIZE;
+        return MIFARE_OK;
+    }
+    tarjeta.estado = CARD_IDLE; // Cualquier otra cosa la saca de la sesion
+    tarjeta.sector_autenticado = -1;
+    return MIFARE_NO_TAG;
+}
+
+static mifare_status fake_authenticate(uint8_t modo, uint8_t bloque, const uint8_t * clave,
+                                       const uint8_t * uid) {
+    (void)modo;
+    autenticaciones++;
+    lector_liberado = false;
+    reloj_us += 2000;
+    if (!tarjeta.en_campo || tarjeta.estado != CARD_ACTIVE ||
+        memcmp(uid, tarjeta.uid, MIFARE_UID_LEN) != 0) {
+        tarjeta.estado = CARD_IDLE;
+        tarjeta.sector_autenticado = -1;
+        return MIFARE_NO_TAG; // No es la tarjeta seleccionada: nadie contesta
+    }
+    if (memcmp(clave, tarjeta.clave, MIFARE_KEY_LEN) != 0) {
+        tarjeta.estado = CARD_IDLE;
+        tarjeta.sector_autenticado = -1;
+        return MIFARE_AUTH_ERR;
+    }
+    tarjeta.sector_autenticado = bloque / MIFARE_BLOCKS_PER_SECT;
+    cifrado = true;
+    return MIFARE_OK;
+}
+
+static void fake_release(void) {
+    lector_liberado = true;
+    cifrado = false;
+}
+
+static const mifare_pcd fake_pcd = {fake_transceive, fake_authenticate, fake_release};
+
+/*El REQA de get_RFID_event_ocurrence entre dos lecturas saca a la tarjeta de ACTIVE*/
+static void poll_de_la_aplicacion(void) {
+    tarjeta.estado = CARD_IDLE;
+    tarjeta.sector_autenticado = -1;
+}
+
+static void retirar_tarjeta(void) {
+    tarjeta.en_campo = false;
+    tarjeta.estado = CARD_IDLE;
+    tarjeta.sector_autenticado = -1;
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    memset(&tarjeta, 0, sizeof(tarjeta));
+    tarjeta.en_campo = true;
+    tarjeta.sector_autenticado = -1;
+    memcpy(tarjeta.uid, (uint8_t[]){0x93, 0x2A, 0x4C, 0x1B}, MIFARE_UID_LEN);
+    memcpy(tarjeta.clave, clave_a, MIFARE_KEY_LEN);
+    for (int b = 0; b < MIFARE_SECTORS * MIFARE_BLOCKS_PER_SECT; b++) {
+        memset(tarjeta.bloques[b], b, MIFARE_BLOCK_SIZE);
+    }
+    tramas = 0;
+    autenticaciones = 0;
+    lector_liberado = false;
+    cifrado = false;
+    bcc_corrupto = false;
+    reloj_us = 0;
+    MIFARE_Init(&fake_pcd, reloj_falso);
+}
+
+void test_lectura_hace_el_handshake_completo(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[3 * MIFARE_BLOCK_SIZE];
+
+    TEST_ASSERT_EQUAL(MIFARE_OK,
+                      MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 3, clave_a, uid, datos));
+    TEST_ASSERT_EQUAL_MEMORY(tarjeta.uid, uid, MIFARE_UID_LEN);
+    TEST_ASSERT_EQUAL_MEMORY(tarjeta.bloques[8], &datos[0], MIFARE_BLOCK_SIZE);
+    TEST_ASSERT_EQUAL_MEMORY(tarjeta.bloques[10], &datos[32], MIFARE_BLOCK_SIZE);
+    TEST_ASSERT_EQUAL(6, tramas); // Request, anticolision, select y tres bloques
+    TEST_ASSERT_EQUAL(1, autenticaciones); // Una sola para todo el sector
+    TEST_ASSERT_EQUAL(8000, MIFARE_GetStats()->ultima_us);
+    TEST_ASSERT_TRUE(lector_liberado);
+    TEST_ASSERT_FALSE(cifrado); // El REQA de la aplicacion sale en claro
+}
+
+void test_cada_lectura_repite_el_handshake(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[2 * MIFARE_BLOCK_SIZE];
+
+    MIFARE_ReadCredential(SECTOR_CREDENCIAL, 1, 2, clave_a, uid, datos);
+    poll_de_la_aplicacion();
+    tramas = 0;
+    autenticaciones = 0;
+    reloj_us = 0;
+
+    TEST_ASSERT_EQUAL(MIFARE_OK, MIFARE_ReadCredential(5, 0, 1, clave_a, uid, datos));
+    TEST_ASSERT_EQUAL(4, tramas);
+    TEST_ASSERT_EQUAL(1, autenticaciones);
+    TEST_ASSERT_EQUAL_MEMORY(tarjeta.bloques[20], datos, MIFARE_BLOCK_SIZE);
+
+    const mifare_stats * stats = MIFARE_GetStats();
+    TEST_ASSERT_EQUAL(2, stats->lecturas);
+    TEST_ASSERT_EQUAL(6000, stats->ultima_us);
+    TEST_ASSERT_EQUAL(7000, stats->maxima_us);
+}
+
+void test_tarjeta_retirada(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[MIFARE_BLOCK_SIZE];
+
+    retirar_tarjeta();
+    TEST_ASSERT_EQUAL(MIFARE_NO_TAG,
+                      MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 1, clave_a, uid, datos));
+    TEST_ASSERT_EQUAL(1, MIFARE_GetStats()->fallidas);
+    TEST_ASSERT_TRUE(lector_liberado);
+}
+
+void test_otra_tarjeta_en_el_campo(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[MIFARE_BLOCK_SIZE];
+
+    MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 1, clave_a, uid, datos);
+    retirar_tarjeta();
+    tarjeta.en_campo = true;
+    tarjeta.uid[3] = 0x77;
+
+    TEST_ASSERT_EQUAL(MIFARE_OK,
+                      MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 1, clave_a, uid, datos));
+    TEST_ASSERT_EQUAL_HEX8(0x77, uid[3]);
+}
+
+void test_clave_incorrecta(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[MIFARE_BLOCK_SIZE];
+    uint8_t otra_clave[MIFARE_KEY_LEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+    TEST_ASSERT_EQUAL(MIFARE_AUTH_ERR,
+                      MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 1, otra_clave, uid, datos));
+    TEST_ASSERT_EQUAL(1, autenticaciones);
+    TEST_ASSERT_EQUAL(0, MIFARE_GetStats()->lecturas);
+    TEST_ASSERT_FALSE(cifrado);
+}
+
+void test_el_trailer_no_se_lee(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[4 * MIFARE_BLOCK_SIZE];
+
+    TEST_ASSERT_EQUAL(MIFARE_ERR,
+                      MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 4, clave_a, uid, datos));
+    TEST_ASSERT_EQUAL(MIFARE_ERR, MIFARE_ReadCredential(MIFARE_SECTORS, 0, 1, clave_a, uid,
+                                                        datos));
+    TEST_ASSERT_EQUAL(0, tramas);
+}
+
+void test_anticolision_con_bcc_invalido(void) {
+    uint8_t uid[MIFARE_UID_LEN];
+    uint8_t datos[MIFARE_BLOCK_SIZE];
+
+    bcc_corrupto = true;
+    TEST_ASSERT_EQUAL(MIFARE_ERR,
+                      MIFARE_ReadCredential(SECTOR_CREDENCIAL, 0, 1, clave_a, uid, datos));
+    TEST_ASSERT_EQUAL(2, tramas); // No se llega a seleccionar
+}
@@ -0,0 +1,117 @@
+#include "unity.h"
+#include "TASKS.h"
+
+static uint32_t reloj_us;
+static uint32_t avance_por_lectura;
+static bool listo;
+static int pasos;
+
+static uint32_t reloj_falso(void) {
+    reloj_us += avance_por_lectura;
+    return reloj_us;
+}
+
+static task_result inmediata(task_ctx * ctx) {
+    TASK_BEGIN(ctx);
+    pasos++;
+    TASK_END(ctx);
+}
+
+static task_result espera_listo(task_ctx * ctx) {
+    TASK_BEGIN(ctx);
+    pasos++;
+    TASK_WAIT_UNTIL(ctx, listo);
+    pasos++;
+    TASK_END(ctx);
+}
+
+/*Procesa de a un paso por reanudacion, como una escritura larga partida en bloques*/
+static task_result por_partes(task_ctx * ctx) {
+    static int bloque;
+    TASK_BEGIN(ctx);
+    for (bloque = 0; bloque < 100; bloque++) {
+        pasos++;
+        TASK_YIELD(ctx);
+    }
+    TASK_END(ctx);
+}
+
+static task_result espera_1(task_ctx * ctx) {
+    TASK_BEGIN(ctx);
+    TASK_WAIT_UNTIL(ctx, listo);
+    TASK_END(ctx);
+}
+static task_result espera_2(task_ctx * ctx) {
+    return espera_1(ctx);
+}
+static task_result espera_3(task_ctx * ctx) {
+    return espera_1(ctx);
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    reloj_us = 0;
+    avance_por_lectura = 0;
+    listo = false;
+    pasos = 0;
+    TASKS_Init(reloj_falso);
+}
+
+void test_tarea_sin_espera_termina_al_iniciarse(void) {
+    TEST_ASSERT_TRUE(TASKS_Start(inmediata));
+    TEST_ASSERT_EQUAL(1, pasos);
+    TEST_ASSERT_EQUAL(0, TASKS_Pending());
+}
+
+void test_tarea_bloqueada_se_reanuda_al_cumplirse_la_condicion(void) {
+    TASKS_Start(espera_listo);
+    TEST_ASSERT_EQUAL(1, pasos);
+    TEST_ASSERT_EQUAL(1, TASKS_Run(1000));
+    TEST_ASSERT_EQUAL(1, pasos); // No se repite lo anterior a la espera
+    TEST_ASSERT_EQUAL(0, TASKS_Ready());
+
+    listo = true;
+    TEST_ASSERT_EQUAL(0, TASKS_Run(1000));
+    TEST_ASSERT_EQUAL(2, pasos);
+}
+
+void test_iniciar_una_tarea_en_curso_la_reinicia(void) {
+    TASKS_Start(espera_listo);
+    TASKS_Start(espera_listo);
+    TEST_ASSERT_EQUAL(2, pasos);
+    TEST_ASSERT_EQUAL(1, TASKS_Pending());
+}
+
+void test_tarea_cancelada_no_se_reanuda(void) {
+    TASKS_Start(espera_listo);
+    TASKS_Cancel(espera_listo);
+    listo = true;
+    TEST_ASSERT_EQUAL(0, TASKS_Run(1000));
+    TEST_ASSERT_EQUAL(1, pasos);
+}
+
+void test_el_presupuesto_acota_cada_vuelta(void) {
+    TASKS_Start(por_partes);
+    TEST_ASSERT_EQUAL(1, pasos);
+
+    avance_por_lectura = 100; // Cada pasada consume 100 us
+    TEST_ASSERT_EQUAL(1, TASKS_Run(1000));
+    TEST_ASSERT_EQUAL(11, pasos);
+    TEST_ASSERT_EQUAL(1, TASKS_Ready()); // El lazo no deberia dormir todavia
+
+    avance_por_lectura = 0; // Con tiempo de sobra termina en una sola vuelta
+    TEST_ASSERT_EQUAL(0, TASKS_Run(1000));
+    TEST_ASSERT_EQUAL(100, pasos);
+}
+
+void test_sin_lugar_no_se_inicia(void) {
+    TEST_ASSERT_TRUE(TASKS_Start(espera_1));
+    TEST_ASSERT_TRUE(TASKS_Start(espera_2));
+    TEST_ASSERT_TRUE(TASKS_Start(espera_3));
+    TEST_ASSERT_TRUE(TASKS_Start(espera_listo));
+    TEST_ASSERT_FALSE(TASKS_Start(por_partes));
+    TEST_ASSERT_EQUAL(TASKS_MAX, TASKS_Pending());
+}
@@ -0,0 +1,207 @@
+#include "unity.h"
+#include "USERS_INDEX.h"
+#include "USERS_MATCH.h"
+#include "ACCESS_RULES.h"
+#include "BYTES.h"
+#include <string.h>
+
+static const user tabla_compilada[] = {{{0x20, 0, 0, 0}, {1, 1, 1, 1}},
+                                       {{0x10, 0, 0, 0}, {2, 2, 2, 2}},
+                                       {{0x30, 0, 0, 0}, {3, 3, 3, 3}}};
+
+static uint8_t delta[USERS_DELTA_HEADER_LEN + 64 * USERS_DELTA_RECORD_LEN];
+static uint32_t delta_len;
+
+static void delta_nuevo(uint32_t base, uint32_t nueva) {
+    memcpy(delta, USERS_DELTA_MAGIC, 4);
+    BYTES_PutU32(&delta[4], base);
+    BYTES_PutU32(&delta[8], nueva);
+    BYTES_PutU32(&delta[12], 0);
+    delta_len = USERS_DELTA_HEADER_LEN;
+}
+
+static void delta_registro(users_delta_op op, uint8_t uid, uint8_t pin, uint32_t id) {
+    uint8_t * registro = &delta[delta_len];
+    registro[0] = (uint8_t)op;
+    memset(&registro[1], 0, 4);
+    registro[1] = uid;
+    memset(&registro[5], pin, 4);
+    BYTES_PutU32(&registro[9], id);
+    delta_len += USERS_DELTA_RECORD_LEN;
+    BYTES_PutU32(&delta[12], (delta_len - USERS_DELTA_HEADER_LEN) / USERS_DELTA_RECORD_LEN);
+}
+
+static bool existe(uint8_t uid) {
+    uint8_t tarjeta[4] = {uid, 0, 0, 0};
+    return USERS_INDEX_Lookup(tarjeta, NULL);
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    USERS_INDEX_Init(tabla_compilada, 3);
+    ACCESS_RULES_Init(ACCESS_ALL_GROUPS);
+    ACCESS_RULES_SetTime(0, 0, 0); // Con la hora fijada solo el horario decide
+}
+
+void test_indice_inicial_con_la_tabla_compilada(void) {
+    users_entry usuario;
+    uint8_t tarjeta[4] = {0x30, 0, 0, 0};
+
+    TEST_ASSERT_EQUAL(1, USERS_INDEX_GetVersion());
+    TEST_ASSERT_EQUAL(3, USERS_INDEX_GetCount());
+    TEST_ASSERT_TRUE(USERS_INDEX_Lookup(tarjeta, &usuario));
+    TEST_ASSERT_EQUAL(2, usuario.UserId);
+    TEST_ASSERT_EQUAL(3, usuario.UserPin[0]);
+    TEST_ASSERT_FALSE(existe(0x40));
+}
+
+void test_delta_con_altas_bajas_y_modificaciones(void) {
+    users_entry usuario;
+    uint8_t tarjeta[4] = {0x20, 0, 0, 0};
+
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_ADD, 0x05, 5, 10);
+    delta_registro(USERS_DELTA_REMOVE, 0x10, 0, 0);
+    delta_registro(USERS_DELTA_MODIFY, 0x20, 9, 1);
+    delta_registro(USERS_DELTA_ADD, 0x40, 4, 11);
+    TEST_ASSERT_EQUAL(USERS_SYNC_BUSY, USERS_INDEX_BeginDelta(delta, delta_len));
+    while (USERS_INDEX_SyncStep(1) == USERS_SYNC_BUSY) {
+    }
+
+    TEST_ASSERT_EQUAL(USERS_SYNC_DONE, USERS_INDEX_SyncStep(1));
+    TEST_ASSERT_EQUAL(2, USERS_INDEX_GetVersion());
+    TEST_ASSERT_EQUAL(4, USERS_INDEX_GetCount());
+    TEST_ASSERT_TRUE(existe(0x05));
+    TEST_ASSERT_FALSE(existe(0x10));
+    TEST_ASSERT_TRUE(existe(0x40));
+    TEST_ASSERT_TRUE(USERS_INDEX_Lookup(tarjeta, &usuario));
+    TEST_ASSERT_EQUAL(9, usuario.UserPin[0]);
+}
+
+void test_lecturas_durante_el_delta_usan_la_version_anterior(void) {
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_REMOVE, 0x10, 0, 0);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 12);
+    USERS_INDEX_BeginDelta(delta, delta_len);
+
+    TEST_ASSERT_EQUAL(USERS_SYNC_BUSY, USERS_INDEX_SyncStep(2));
+    TEST_ASSERT_TRUE(existe(0x10));
+    TEST_ASSERT_FALSE(existe(0x50));
+    TEST_ASSERT_EQUAL(1, USERS_INDEX_GetVersion());
+
+    while (USERS_INDEX_SyncStep(2) == USERS_SYNC_BUSY) {
+    }
+    TEST_ASSERT_FALSE(existe(0x10));
+    TEST_ASSERT_TRUE(existe(0x50));
+}
+
+void test_la_baja_borra_el_horario_al_publicar_la_version(void) {
+    const access_window nunca[] = {{0, 0, 0}};
+    ACCESS_RULES_Compile(1, nunca, 1, ACCESS_ALL_GROUPS, false); // Usuario de la tarjeta 0x10
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_REMOVE, 0x10, 0, 0);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 12);
+    USERS_INDEX_BeginDelta(delta, delta_len);
+
+    USERS_INDEX_SyncStep(2);
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(1)); // La version activa todavia lo acepta
+    while (USERS_INDEX_SyncStep(2) == USERS_SYNC_BUSY) {
+    }
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1)); // Un id reutilizado no hereda el horario
+}
+
+void test_el_horario_sigue_al_usuario_que_cambia_de_id(void) {
+    const access_window nunca[] = {{0, 0, 0}};
+    ACCESS_RULES_Compile(1, nunca, 1, ACCESS_ALL_GROUPS, false); // Usuario de la tarjeta 0x10
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_MODIFY, 0x10, 1, 40);
+    USERS_INDEX_BeginDelta(delta, delta_len);
+    while (USERS_INDEX_SyncStep(2) == USERS_SYNC_BUSY) {
+    }
+
+    TEST_ASSERT_FALSE(ACCESS_RULES_Check(40));
+    TEST_ASSERT_TRUE(ACCESS_RULES_Check(1));
+}
+
+void test_delta_sobre_otra_version_es_rechazado(void) {
+    delta_nuevo(7, 8);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 12);
+    TEST_ASSERT_EQUAL(USERS_SYNC_ERROR, USERS_INDEX_BeginDelta(delta, delta_len));
+    TEST_ASSERT_EQUAL(1, USERS_INDEX_GetVersion());
+}
+
+void test_delta_que_no_avanza_la_version_es_rechazado(void) {
+    delta_nuevo(1, 1);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 12);
+    TEST_ASSERT_EQUAL(USERS_SYNC_ERROR, USERS_INDEX_BeginDelta(delta, delta_len));
+    delta_nuevo(1, 0);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 12);
+    TEST_ASSERT_EQUAL(USERS_SYNC_ERROR, USERS_INDEX_BeginDelta(delta, delta_len));
+    TEST_ASSERT_EQUAL(1, USERS_INDEX_GetVersion());
+}
+
+void test_delta_truncado_es_rechazado(void) {
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 12);
+    TEST_ASSERT_EQUAL(USERS_SYNC_ERROR, USERS_INDEX_BeginDelta(delta, delta_len - 1));
+}
+
+void test_delta_inconsistente_no_modifica_el_indice(void) {
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_ADD, 0x05, 5, 10);
+    delta_registro(USERS_DELTA_REMOVE, 0x15, 0, 0); // No existe
+    USERS_INDEX_BeginDelta(delta, delta_len);
+    while (USERS_INDEX_SyncStep(1) == USERS_SYNC_BUSY) {
+    }
+
+    TEST_ASSERT_EQUAL(USERS_SYNC_ERROR, USERS_INDEX_SyncStep(1));
+    TEST_ASSERT_EQUAL(1, USERS_INDEX_GetVersion());
+    TEST_ASSERT_FALSE(existe(0x05));
+}
+
+void test_delta_desordenado_es_rechazado(void) {
+    delta_nuevo(1, 2);
+    delta_registro(USERS_DELTA_ADD, 0x50, 5, 10);
+    delta_registro(USERS_DELTA_ADD, 0x45, 5, 11);
+    USERS_INDEX_BeginDelta(delta, delta_len);
+    while (USERS_INDEX_SyncStep(1) == USERS_SYNC_BUSY) {
+    }
+    TEST_ASSERT_EQUAL(1, USERS_INDEX_GetVersion());
+}
+
+void test_indice_grande_usa_busqueda_binaria(void) {
+    delta_nuevo(1, 2);
+    for (uint8_t uid = 0x40; uid < 0x40 + 40; uid++) {
+        delta_registro(USERS_DELTA_ADD, uid, uid, uid);
+    }
+    USERS_INDEX_BeginDelta(delta, delta_len);
+    while (USERS_INDEX_SyncStep(64) == USERS_SYNC_BUSY) {
+    }
+    delta_nuevo(2, 3);
+    for (uint8_t uid = 0x70; uid < 0x70 + 40; uid++) {
+        delta_registro(USERS_DELTA_ADD, uid, uid, uid);
+    }
+    USERS_INDEX_BeginDelta(delta, delta_len);
+    while (USERS_INDEX_SyncStep(64) == USERS_SYNC_BUSY) {
+    }
+
+    TEST_ASSERT_GREATER_THAN(USERS_INDEX_LINEAR_MAX, USERS_INDEX_GetCount());
+    TEST_ASSERT_TRUE(existe(0x10));
+    TEST_ASSERT_TRUE(existe(0x67));
+    TEST_ASSERT_TRUE(existe(0x97));
+    TEST_ASSERT_FALSE(existe(0x68));
+}
+
+void test_auditoria_por_lote(void) {
+    KeyCard tarjetas[4] = {{0x30, 0, 0, 0}, {0x31, 0, 0, 0}, {0x10, 0, 0, 0}, {0x00, 0, 0, 0}};
+    bool presentes[4];
+
+    USERS_INDEX_LookupBatch(tarjetas, 4, presentes);
+    TEST_ASSERT_TRUE(presentes[0]);
+    TEST_ASSERT_FALSE(presentes[1]);
+    TEST_ASSERT_TRUE(presentes[2]);
+    TEST_ASSERT_FALSE(presentes[3]);
+}
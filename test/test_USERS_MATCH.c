@@ -0,0 +1,52 @@
+#include "unity.h"
+#include "USERS_MATCH.h"
+
+#define COLUMNA_LARGO 100
+
+static uint32_t columna[COLUMNA_LARGO];
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    USERS_MATCH_Init();
+    for (uint32_t i = 0; i < COLUMNA_LARGO; i++) {
+        columna[i] = 0x1000U + 3 * i;
+    }
+}
+
+void test_uid_empaquetado_respeta_el_orden_de_los_bytes(void) {
+    uint8_t menor[4] = {0x01, 0xFF, 0xFF, 0xFF};
+    uint8_t mayor[4] = {0x02, 0x00, 0x00, 0x00};
+    TEST_ASSERT_EQUAL_HEX32(0x01FFFFFF, USERS_MATCH_PackUid(menor));
+    TEST_ASSERT_TRUE(USERS_MATCH_PackUid(menor) < USERS_MATCH_PackUid(mayor));
+}
+
+void test_encuentra_cada_posicion_de_la_columna(void) {
+    for (uint32_t i = 0; i < COLUMNA_LARGO; i++) {
+        TEST_ASSERT_EQUAL(i, USERS_MATCH_Find(columna, COLUMNA_LARGO, columna[i]));
+    }
+}
+
+void test_uid_inexistente(void) {
+    TEST_ASSERT_EQUAL(USERS_MATCH_NOT_FOUND, USERS_MATCH_Find(columna, COLUMNA_LARGO, 0x1001));
+    TEST_ASSERT_EQUAL(USERS_MATCH_NOT_FOUND, USERS_MATCH_Find(columna, 0, columna[0]));
+}
+
+void test_vectorizado_coincide_con_escalar_en_todos_los_largos(void) {
+    for (uint32_t largo = 0; largo <= COLUMNA_LARGO; largo++) {
+        TEST_ASSERT_EQUAL(USERS_MATCH_FindScalar(columna, largo, columna[COLUMNA_LARGO - 1]),
+                          USERS_MATCH_Find(columna, largo, columna[COLUMNA_LARGO - 1]));
+    }
+}
+
+void test_busqueda_por_lote(void) {
+    uint32_t uids[3] = {columna[97], 0x0FFF, columna[0]};
+    int32_t posiciones[3];
+
+    USERS_MATCH_Batch(columna, COLUMNA_LARGO, uids, 3, posiciones);
+    TEST_ASSERT_EQUAL(97, posiciones[0]);
+    TEST_ASSERT_EQUAL(USERS_MATCH_NOT_FOUND, posiciones[1]);
+    TEST_ASSERT_EQUAL(0, posiciones[2]);
+}
@@ -0,0 +1,149 @@
+#include "unity.h"
+#include "USERS_VALIDATOR.h"
+#include <string.h>
+
+static uint8_t tarjeta[4] = {0x93, 0x2A, 0x4C, 0x1B};
+static uint8_t pin_servidor[4] = {9, 8, 7, 6};
+
+static int consultas_enviadas;
+static bool servidor_acepta_consultas;
+static bool respuesta_lista;
+static validator_verdict respuesta_servidor;
+
+static bool fake_request(const uint8_t * uid) {
+    (void)uid;
+    if (!servidor_acepta_consultas) {
+        return false;
+    }
+    consultas_enviadas++;
+    return true;
+}
+
+static bool fake_poll(uint8_t * uid, validator_verdict * verdict, uint8_t * pin) {
+    if (!respuesta_lista) {
+        return false;
+    }
+    respuesta_lista = false;
+    memcpy(uid, tarjeta, 4);
+    memcpy(pin, pin_servidor, 4);
+    *verdict = respuesta_servidor;
+    return true;
+}
+
+static const users_validator_backend fake_backend = {fake_request, fake_poll};
+
+static void responder(validator_verdict decision, uint32_t now) {
+    respuesta_servidor = decision;
+    respuesta_lista = true;
+    USERS_VALIDATOR_Poll(now);
+}
+
+/**
+ * @brief Funcion que se ejecuta antes de cada test (nombre especifico de ceedling)
+ *
+ */
+void setUp(void) {
+    consultas_enviadas = 0;
+    servidor_acepta_consultas = true;
+    respuesta_lista = false;
+    USERS_VALIDATOR_Init(&fake_backend);
+}
+
+void test_sin_backend_siempre_se_usa_la_tabla_local(void) {
+    uint8_t pin[4];
+    USERS_VALIDATOR_Init(NULL);
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN, USERS_VALIDATOR_Lookup(tarjeta, pin, 0));
+    TEST_ASSERT_FALSE(USERS_VALIDATOR_Pending(tarjeta));
+}
+
+void test_primer_lectura_no_bloquea_y_deja_consulta_en_vuelo(void) {
+    uint8_t pin[4];
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN, USERS_VALIDATOR_Lookup(tarjeta, pin, 0));
+    TEST_ASSERT_TRUE(USERS_VALIDATOR_Pending(tarjeta));
+    TEST_ASSERT_EQUAL(1, consultas_enviadas);
+
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 10); // No se duplica la consulta en vuelo
+    TEST_ASSERT_EQUAL(1, consultas_enviadas);
+}
+
+void test_respuesta_del_servidor_queda_en_cache(void) {
+    uint8_t pin[4] = {0};
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 0);
+    responder(VALIDATOR_ALLOW, 50);
+    TEST_ASSERT_FALSE(USERS_VALIDATOR_Pending(tarjeta));
+
+    TEST_ASSERT_EQUAL(VALIDATOR_ALLOW, USERS_VALIDATOR_Lookup(tarjeta, pin, 100));
+    TEST_ASSERT_EQUAL_MEMORY(pin_servidor, pin, 4);
+    TEST_ASSERT_EQUAL(1, consultas_enviadas);
+}
+
+void test_refresco_anticipado_mantiene_la_decision_vigente(void) {
+    uint8_t pin[4];
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 0);
+    responder(VALIDATOR_ALLOW, 0);
+
+    TEST_ASSERT_EQUAL(VALIDATOR_ALLOW, USERS_VALIDATOR_Lookup(tarjeta, pin, VALIDATOR_REFRESH_MS));
+    TEST_ASSERT_EQUAL(2, consultas_enviadas);
+    TEST_ASSERT_TRUE(USERS_VALIDATOR_Pending(tarjeta));
+}
+
+void test_decision_vencida_vuelve_a_la_tabla_local(void) {
+    uint8_t pin[4];
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 0);
+    responder(VALIDATOR_DENY, 0);
+
+    TEST_ASSERT_EQUAL(VALIDATOR_DENY, USERS_VALIDATOR_Lookup(tarjeta, pin, 1));
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN,
+                      USERS_VALIDATOR_Lookup(tarjeta, pin, VALIDATOR_NEGATIVE_TTL_MS));
+}
+
+void test_servidor_lento_libera_la_consulta(void) {
+    uint8_t pin[4];
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 0);
+    USERS_VALIDATOR_Poll(VALIDATOR_RESPONSE_TIMEOUT_MS);
+    TEST_ASSERT_FALSE(USERS_VALIDATOR_Pending(tarjeta));
+
+    USERS_VALIDATOR_Lookup(tarjeta, pin, VALIDATOR_RESPONSE_TIMEOUT_MS + 1); // Se reintenta
+    TEST_ASSERT_EQUAL(2, consultas_enviadas);
+}
+
+void test_servidor_caido_no_deja_consultas_en_vuelo(void) {
+    uint8_t pin[4];
+    servidor_acepta_consultas = false;
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN, USERS_VALIDATOR_Lookup(tarjeta, pin, 0));
+    TEST_ASSERT_FALSE(USERS_VALIDATOR_Pending(tarjeta));
+}
+
+void test_cache_llena_desaloja_la_menos_usada(void) {
+    uint8_t pin[4];
+    uint8_t otra[4] = {0, 0, 0, 0};
+
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 0);
+    responder(VALIDATOR_ALLOW, 0);
+    for (uint8_t i = 0; i < VALIDATOR_CACHE_SIZE; i++) {
+        otra[0] = i + 1;
+        USERS_VALIDATOR_Lookup(otra, pin, 1);
+    }
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN, USERS_VALIDATOR_Lookup(tarjeta, pin, 2));
+}
+
+void test_refresco_anticipado_de_una_decision_negativa(void) {
+    uint8_t pin[4];
+    USERS_VALIDATOR_Lookup(tarjeta, pin, 0);
+    responder(VALIDATOR_DENY, 0);
+
+    TEST_ASSERT_EQUAL(VALIDATOR_DENY,
+                      USERS_VALIDATOR_Lookup(tarjeta, pin, VALIDATOR_NEGATIVE_REFRESH_MS));
+    TEST_ASSERT_EQUAL(2, consultas_enviadas);
+}
+
+void test_respuesta_no_pedida_o_tardia_se_descarta(void) {
+    uint8_t pin[4];
+    responder(VALIDATOR_ALLOW, 0); // Nadie consulto por esta tarjeta
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN, USERS_VALIDATOR_Lookup(tarjeta, pin, 1));
+
+    USERS_VALIDATOR_Poll(VALIDATOR_RESPONSE_TIMEOUT_MS + 1);
+    responder(VALIDATOR_ALLOW, VALIDATOR_RESPONSE_TIMEOUT_MS + 2); // Llega despues del timeout
+    TEST_ASSERT_EQUAL(VALIDATOR_UNKNOWN,
+                      USERS_VALIDATOR_Lookup(tarjeta, pin, VALIDATOR_RESPONSE_TIMEOUT_MS + 3));
+}